@@ -0,0 +1,104 @@
+// Parallel executor scaling benchmark (hosted builds only).
+//
+//   parallel_bench [rows] [maxThreads]
+//
+// Builds one table, then times count / filter / aggregate / deleteOlderThan
+// / purge with 1, 2, 4, ... maxThreads workers (default: all hardware
+// threads) and prints the speed-up against the single-threaded run.
+#include "../snail_parallel.h"
+#include "../snaildb.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+static double nowMs() {
+  using namespace std::chrono;
+  return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+}
+
+static void buildTable(SnailDB &db, size_t rows) {
+  db.addIntColProp("id", 0);
+  db.addStrColProp("sensor", 16);
+  db.addDoubleColProp("value", 0);
+  db.reserve(rows);
+
+  const char *sensors[] = {"Temp_A", "Temp_B", "Door_A", "Door_B", "Hum_A",
+                           "Hum_B", "Volt_A", "Volt_B"};
+  const size_t chunk = 65536;
+  std::vector<int> ids(chunk);
+  std::vector<const char *> names(chunk);
+  std::vector<double> values(chunk);
+  std::vector<uint32_t> ts(chunk);
+
+  for (size_t base = 0; base < rows; base += chunk) {
+    size_t n = std::min(chunk, rows - base);
+    for (size_t i = 0; i < n; ++i) {
+      size_t r = base + i;
+      ids[i] = (int)(r * 2654435761u % 1000003u);
+      names[i] = sensors[r % 8];
+      values[i] = (double)(r % 1000) / 10.0;
+      ts[i] = (uint32_t)r;
+    }
+    SnailBatch batch(n);
+    batch.setInts(0, ids.data());
+    batch.setStrs(1, names.data());
+    batch.setDoubles(2, values.data());
+    batch.setTimestamps(ts.data());
+    db.insertBatch(batch);
+  }
+}
+
+int main(int argc, char **argv) {
+  size_t rows = argc > 1 ? (size_t)std::strtoull(argv[1], nullptr, 10) : 4000000;
+  size_t maxThreads = argc > 2 ? (size_t)std::strtoull(argv[2], nullptr, 10)
+                               : std::thread::hardware_concurrency();
+  if (maxThreads == 0) maxThreads = 1;
+
+  std::printf("rows=%zu maxThreads=%zu\n", rows, maxThreads);
+  std::printf("%-8s %14s %14s %14s %14s %14s\n", "threads", "count", "filter",
+              "aggregate", "deleteOld", "purge");
+
+  double base[5] = {0, 0, 0, 0, 0};
+  for (size_t threads = 1; threads <= maxThreads; threads *= 2) {
+    SnailDB db;
+    buildTable(db, rows);
+    SnailThreadPool pool(threads);
+    SnailExecutor exec(pool);
+    SnailPredicate pred = db.prepare("sensor", "Door_A");
+    SnailAggregate agg;
+    double t[5];
+
+    double t0 = nowMs();
+    volatile size_t active = exec.count(db);
+    t[0] = nowMs() - t0;
+
+    t0 = nowMs();
+    volatile size_t matches = exec.filter(db, pred).size();
+    t[1] = nowMs() - t0;
+
+    t0 = nowMs();
+    exec.aggregate(db, "value", agg);
+    t[2] = nowMs() - t0;
+
+    t0 = nowMs();
+    exec.deleteOlderThan(db, (uint32_t)(rows / 2));
+    t[3] = nowMs() - t0;
+
+    t0 = nowMs();
+    exec.purge(db);
+    t[4] = nowMs() - t0;
+
+    (void)active;
+    (void)matches;
+    if (threads == 1) {
+      for (int k = 0; k < 5; ++k) base[k] = t[k];
+    }
+    std::printf("%-8zu", threads);
+    for (int k = 0; k < 5; ++k) {
+      std::printf(" %8.1fms/%.1fx", t[k], t[k] > 0 ? base[k] / t[k] : 0.0);
+    }
+    std::printf("\n");
+  }
+  return 0;
+}
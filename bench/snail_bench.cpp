@@ -0,0 +1,411 @@
+// SnailDB benchmark suite (hosted builds).
+//
+//   snail_bench [--rows 1000,100000,1000000] [--cardinality 64] [--sorted 1]
+//               [--lookups 1000] [--label name] [--json out.json]
+//
+// For every row count a table (id INT, sensor STR, value INT, ts) is built
+// and the hot paths are timed: variadic vs. batch insert, findRow on sorted,
+// unsorted, indexed and string columns, prepared lookups, softDelete,
+// deleteOlderThan, purge, getSize, cursor scans, SnailStorage save/load and
+// the CSV / JSON Lines / binary exporters (vs. SnailDumper::printTable) and
+// the CSV / JSON Lines importers (single-threaded and on a thread pool).
+//
+// Results are written as JSON (stdout by default) with throughput, latency
+// percentiles for per-call cases, and the process peak RSS. --label tags the
+// run (e.g. a commit hash) so results can be compared across versions.
+#include "../snail_dumper.h"
+#include "../snail_export.h"
+#include "../snail_import.h"
+#include "../snail_storage.h"
+#include "../snaildb.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+// =========================================================
+// Configuration & Helpers
+// =========================================================
+
+struct BenchConfig {
+  std::vector<size_t> rows;
+  size_t cardinality;
+  bool sorted; // 'id' inserted in ascending order (binary search path)
+  size_t lookups;
+  std::string label;
+  std::string jsonPath;
+};
+
+struct BenchResult {
+  std::string name;
+  size_t rows;
+  size_t ops;
+  double seconds;
+  bool hasLatency;
+  double p50, p90, p99, max; // nanoseconds per op
+};
+
+static double nowSec() {
+  using namespace std::chrono;
+  return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+static uint32_t nextRand(uint32_t &state) {
+  // xorshift32: deterministic across runs and platforms
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}
+
+static long peakRssKb() {
+#if defined(__unix__) || defined(__APPLE__)
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024; // bytes on macOS
+#else
+    return usage.ru_maxrss; // kilobytes on Linux
+#endif
+  }
+#endif
+  return -1;
+}
+
+static std::vector<size_t> parseList(const char *s) {
+  std::vector<size_t> out;
+  while (*s) {
+    char *end;
+    unsigned long long v = std::strtoull(s, &end, 10);
+    if (end == s) break;
+    if (*end == 'K' || *end == 'k') { v *= 1000; end++; }
+    else if (*end == 'M' || *end == 'm') { v *= 1000000; end++; }
+    out.push_back((size_t)v);
+    s = (*end == ',') ? end + 1 : end;
+  }
+  return out;
+}
+
+// Table contents are generated once per row count and shared by every case
+struct Dataset {
+  std::vector<int> ids;
+  std::vector<std::string> sensors;
+  std::vector<const char *> sensorPtrs;
+  std::vector<int> values;
+  std::vector<uint32_t> ts;
+};
+
+static void makeDataset(Dataset &d, size_t rows, const BenchConfig &cfg) {
+  uint32_t rng = 0x9E3779B9u;
+  d.ids.resize(rows);
+  d.values.resize(rows);
+  d.ts.resize(rows);
+  d.sensorPtrs.resize(rows);
+
+  std::vector<std::string> names(cfg.cardinality);
+  for (size_t i = 0; i < names.size(); ++i) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "Sensor_%04zu", i);
+    names[i] = buf;
+  }
+  d.sensors = names;
+
+  for (size_t i = 0; i < rows; ++i) d.ids[i] = (int)i;
+  if (!cfg.sorted) {
+    for (size_t i = rows; i > 1; --i) std::swap(d.ids[i - 1], d.ids[nextRand(rng) % i]);
+  }
+  for (size_t i = 0; i < rows; ++i) {
+    d.values[i] = (int)(nextRand(rng) % 1000000);
+    d.ts[i] = (uint32_t)i;
+    d.sensorPtrs[i] = d.sensors[nextRand(rng) % cfg.cardinality].c_str();
+  }
+}
+
+static void defineSchema(SnailDB &db) {
+  db.addIntColProp("id", 0);
+  db.addStrColProp("sensor", 16);
+  db.addIntColProp("value", 0);
+}
+
+static void fillBatch(SnailDB &db, const Dataset &d) {
+  const size_t chunk = 4096;
+  size_t rows = d.ids.size();
+  for (size_t base = 0; base < rows; base += chunk) {
+    size_t n = std::min(chunk, rows - base);
+    SnailBatch batch(n);
+    batch.setInts(0, &d.ids[base]);
+    batch.setStrs(1, &d.sensorPtrs[base]);
+    batch.setInts(2, &d.values[base]);
+    batch.setTimestamps(&d.ts[base]);
+    db.insertBatch(batch);
+  }
+}
+
+// =========================================================
+// Measurement
+// =========================================================
+
+class Runner {
+public:
+  explicit Runner(std::vector<BenchResult> &out) : out(out) {}
+
+  // Whole-operation timing: one sample covering 'ops' units of work
+  template <typename F> void bulk(const char *name, size_t rows, size_t ops, F fn) {
+    double t0 = nowSec();
+    fn();
+    double t = nowSec() - t0;
+    BenchResult r = {name, rows, ops, t, false, 0, 0, 0, 0};
+    out.push_back(r);
+  }
+
+  // Per-call timing with latency percentiles; fn(i) performs call i
+  template <typename F> void perCall(const char *name, size_t rows, size_t ops, F fn) {
+    std::vector<double> ns(ops);
+    double total = 0;
+    for (size_t i = 0; i < ops; ++i) {
+      double t0 = nowSec();
+      fn(i);
+      double t = nowSec() - t0;
+      ns[i] = t * 1e9;
+      total += t;
+    }
+    std::sort(ns.begin(), ns.end());
+    BenchResult r = {name, rows, ops, total, true, pct(ns, 0.50), pct(ns, 0.90),
+                     pct(ns, 0.99), ns.empty() ? 0 : ns.back()};
+    out.push_back(r);
+  }
+
+private:
+  static double pct(const std::vector<double> &v, double p) {
+    if (v.empty()) return 0;
+    return v[std::min(v.size() - 1, (size_t)(p * v.size()))];
+  }
+
+  std::vector<BenchResult> &out;
+};
+
+// Keeps results observable so the optimizer cannot drop the calls
+static volatile long long sink = 0;
+
+static void runSuite(size_t rows, const BenchConfig &cfg, std::vector<BenchResult> &results) {
+  Dataset d;
+  makeDataset(d, rows, cfg);
+  Runner run(results);
+  uint32_t rng = 12345;
+
+  // --- Insert ---
+  {
+    SnailDB db;
+    defineSchema(db);
+    db.reserve(rows);
+    run.bulk("insert_variadic", rows, rows, [&] {
+      for (size_t i = 0; i < rows; ++i) {
+        db.insertAt(d.ts[i], d.ids[i], d.sensorPtrs[i], d.values[i]);
+      }
+    });
+  }
+  {
+    SnailDB db;
+    defineSchema(db);
+    db.reserve(rows);
+    run.bulk("insert_batch", rows, rows, [&] { fillBatch(db, d); });
+  }
+
+  // --- Lookups ---
+  SnailDB db;
+  defineSchema(db);
+  fillBatch(db, d);
+
+  // Linear scans cost O(rows) each; scale their count down on big tables
+  size_t lookups = cfg.lookups;
+  size_t scanLookups = std::max<size_t>(10, std::min(lookups, lookups * 10000 / std::max<size_t>(rows, 1)));
+
+  std::vector<std::string> idKeys(lookups), valueKeys(lookups), sensorKeys(lookups);
+  std::vector<int> valueInts(lookups);
+  for (size_t i = 0; i < lookups; ++i) {
+    size_t r = nextRand(rng) % rows;
+    idKeys[i] = std::to_string(d.ids[r]);
+    valueInts[i] = d.values[r];
+    valueKeys[i] = std::to_string(d.values[r]);
+    sensorKeys[i] = d.sensorPtrs[r];
+  }
+
+  run.perCall(cfg.sorted ? "find_sorted" : "find_unsorted_id", rows, cfg.sorted ? lookups : scanLookups,
+              [&](size_t i) { sink += db.findRow("id", idKeys[i]); });
+  run.perCall("find_unsorted", rows, scanLookups,
+              [&](size_t i) { sink += db.findRow("value", valueKeys[i]); });
+  run.perCall("find_str", rows, lookups,
+              [&](size_t i) { sink += db.findRow("sensor", sensorKeys[i]); });
+
+  run.bulk("create_index", rows, rows, [&] { db.createIndex(); });
+  // Same keys as find_str: a low-cardinality token must not cost a walk over
+  // all of its rows
+  run.perCall("find_str_indexed", rows, lookups,
+              [&](size_t i) { sink += db.findRow("sensor", sensorKeys[i]); });
+  run.perCall("find_indexed", rows, lookups,
+              [&](size_t i) { sink += db.findRow("value", valueKeys[i]); });
+  SnailColumnHandle valueCol = db.prepareColumn("value");
+  run.perCall("find_indexed_prepared", rows, lookups,
+              [&](size_t i) { sink += db.findRow(valueCol, valueInts[i]); });
+  SnailPredicate sensorPred = db.prepare("sensor", sensorKeys[0]);
+  run.perCall("find_str_prepared", rows, lookups,
+              [&](size_t) { sink += db.findRow(sensorPred); });
+
+  // --- Scans ---
+  run.perCall("get_size", rows, 20, [&](size_t) { sink += (long long)db.getSize(); });
+  run.bulk("cursor_scan", rows, rows, [&] {
+    db.reset();
+    long long acc = 0;
+    for (size_t i = 0; i < rows; ++i) {
+      acc += db.get<int>(2);
+      db.next();
+    }
+    sink += acc;
+  });
+
+  // --- Persistence ---
+  const char *path = "snail_bench.snail";
+  run.bulk("save", rows, rows, [&] { SnailStorage::save(db, path); });
+  {
+    SnailDB loaded;
+    run.bulk("load", rows, rows, [&] { SnailStorage::load(loaded, path); });
+    sink += (long long)loaded.getSize();
+  }
+  std::remove(path);
+
+  // --- Export (into memory: formatting cost, not disk speed) ---
+  {
+    std::ostringstream os;
+    run.bulk("export_print_table", rows, rows, [&] { SnailDumper::printTable(db, os); });
+    sink += (long long)os.tellp();
+  }
+  {
+    std::ostringstream os;
+    run.bulk("export_csv", rows, rows, [&] { SnailExporter(db).withTimestamps().writeCsv(os); });
+    sink += (long long)os.tellp();
+  }
+  {
+    std::ostringstream os;
+    run.bulk("export_jsonl", rows, rows, [&] { SnailExporter(db).writeJsonLines(os); });
+    sink += (long long)os.tellp();
+  }
+  {
+    std::ostringstream os;
+    run.bulk("export_binary", rows, rows, [&] { SnailExporter(db).writeBinary(os); });
+    sink += (long long)os.tellp();
+  }
+
+  // --- Import (from memory: parsing cost, schema inferred) ---
+  {
+    std::ostringstream csv, jsonl;
+    SnailExporter(db).withTimestamps().writeCsv(csv);
+    SnailExporter(db).withTimestamps().writeJsonLines(jsonl);
+    const std::string csvText = csv.str(), jsonText = jsonl.str();
+    SnailThreadPool pool;
+
+    SnailDB a, b, c;
+    run.bulk("import_csv", rows, rows, [&] {
+      SnailImporter(a).importBuffer(csvText.data(), csvText.size(), IMPORT_CSV);
+    });
+    run.bulk("import_csv_parallel", rows, rows, [&] {
+      SnailImporter(b, &pool).importBuffer(csvText.data(), csvText.size(), IMPORT_CSV);
+    });
+    run.bulk("import_jsonl_parallel", rows, rows, [&] {
+      SnailImporter(c, &pool).importBuffer(jsonText.data(), jsonText.size(), IMPORT_JSONL);
+    });
+    sink += (long long)(a.getSize() + b.getSize() + c.getSize());
+  }
+
+  // --- Lifecycle (destructive: each on a fresh table) ---
+  {
+    size_t deletes = rows / 10;
+    std::vector<size_t> victims(deletes);
+    for (size_t i = 0; i < deletes; ++i) victims[i] = nextRand(rng) % rows;
+    run.bulk("soft_delete", rows, deletes, [&] {
+      for (size_t i = 0; i < deletes; ++i) db.softDelete(victims[i]);
+    });
+  }
+  {
+    SnailDB fresh;
+    defineSchema(fresh);
+    fillBatch(fresh, d);
+    run.bulk("delete_older_than", rows, rows,
+             [&] { fresh.deleteOlderThan((uint32_t)(rows / 2)); });
+    run.bulk("purge", rows, rows, [&] { fresh.purge(); });
+    sink += (long long)fresh.getSize();
+  }
+}
+
+// =========================================================
+// Output
+// =========================================================
+
+static void writeJson(FILE *f, const BenchConfig &cfg, const std::vector<BenchResult> &results) {
+  std::fprintf(f, "{\n  \"suite\": \"snaildb\",\n  \"label\": \"%s\",\n", cfg.label.c_str());
+  std::fprintf(f, "  \"config\": {\"cardinality\": %zu, \"sorted\": %s, \"lookups\": %zu},\n",
+               cfg.cardinality, cfg.sorted ? "true" : "false", cfg.lookups);
+  std::fprintf(f, "  \"peak_rss_kb\": %ld,\n  \"results\": [\n", peakRssKb());
+  for (size_t i = 0; i < results.size(); ++i) {
+    const BenchResult &r = results[i];
+    double opsPerSec = r.seconds > 0 ? r.ops / r.seconds : 0;
+    std::fprintf(f, "    {\"name\": \"%s\", \"rows\": %zu, \"ops\": %zu, \"seconds\": %.6f, "
+                    "\"ops_per_sec\": %.1f",
+                 r.name.c_str(), r.rows, r.ops, r.seconds, opsPerSec);
+    if (r.hasLatency) {
+      std::fprintf(f, ", \"p50_ns\": %.0f, \"p90_ns\": %.0f, \"p99_ns\": %.0f, \"max_ns\": %.0f",
+                   r.p50, r.p90, r.p99, r.max);
+    }
+    std::fprintf(f, "}%s\n", i + 1 < results.size() ? "," : "");
+  }
+  std::fprintf(f, "  ]\n}\n");
+}
+
+int main(int argc, char **argv) {
+  BenchConfig cfg;
+  cfg.rows = parseList("1K,10K,100K,1M");
+  cfg.cardinality = 64;
+  cfg.sorted = true;
+  cfg.lookups = 1000;
+  cfg.label = "dev";
+
+  for (int i = 1; i + 1 < argc; i += 2) {
+    const char *opt = argv[i];
+    const char *val = argv[i + 1];
+    if (!std::strcmp(opt, "--rows")) cfg.rows = parseList(val);
+    else if (!std::strcmp(opt, "--cardinality")) cfg.cardinality = std::max<size_t>(1, std::strtoull(val, nullptr, 10));
+    else if (!std::strcmp(opt, "--sorted")) cfg.sorted = std::atoi(val) != 0;
+    else if (!std::strcmp(opt, "--lookups")) cfg.lookups = std::max<size_t>(1, std::strtoull(val, nullptr, 10));
+    else if (!std::strcmp(opt, "--label")) cfg.label = val;
+    else if (!std::strcmp(opt, "--json")) cfg.jsonPath = val;
+    else {
+      std::fprintf(stderr, "Unknown option: %s\n", opt);
+      return 1;
+    }
+  }
+  // Dictionary tokens are 16-bit
+  if (cfg.cardinality > 65535) cfg.cardinality = 65535;
+
+  std::vector<BenchResult> results;
+  for (size_t rows : cfg.rows) {
+    if (rows == 0) continue;
+    std::fprintf(stderr, "Running %zu rows...\n", rows);
+    runSuite(rows, cfg, results);
+  }
+
+  FILE *f = cfg.jsonPath.empty() ? stdout : std::fopen(cfg.jsonPath.c_str(), "w");
+  if (!f) {
+    std::fprintf(stderr, "Cannot write %s\n", cfg.jsonPath.c_str());
+    return 1;
+  }
+  writeJson(f, cfg, results);
+  if (f != stdout) std::fclose(f);
+  return 0;
+}
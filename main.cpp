@@ -1,8 +1,22 @@
 #include "snail_dumper.h"
+#include "snail_export.h"
+#include "snail_import.h"
+#include "snail_parallel.h"
+#include "snail_query.h"
 #include "snail_storage.h"
+#include "snail_table.h"
 #include "snaildb.h"
 #include <cassert>
+#include <cmath>
+#include <fstream>
 #include <iostream>
+#include <limits>
+#include <sstream>
+
+SNAIL_COLUMN_NAME(IdName, "id");
+SNAIL_COLUMN_NAME(SensorName, "sensor");
+SNAIL_COLUMN_NAME(TempName, "temp");
+SNAIL_COLUMN_NAME(AlarmName, "alarm");
 
 int main() {
   std::cout << "Starting SnailDB v0.5 Final Tests..." << std::endl;
@@ -167,5 +181,943 @@ int main() {
   }
 
   std::cout << "Final Merge & Purge Verification Passed!" << std::endl;
+
+  // 12. Bulk Insert
+  std::cout << "Testing Bulk Insert..." << std::endl;
+  SnailDB bulk;
+  bulk.addIntColProp("id", 0);
+  bulk.addStrColProp("sensor", 10);
+
+  const int ids[] = {10, 11, 12, 13};
+  const char *sensors[] = {"Temp", "Temp", "Door", "Temp"};
+  const uint32_t stamps[] = {1000, 1001, 1002, 1003};
+
+  SnailBatch batch(4);
+  batch.setInts(0, ids);
+  batch.setStrs(1, sensors);
+  batch.setTimestamps(stamps);
+  assert(bulk.insertBatch(batch));
+  assert(bulk.getSize() == 4);
+  assert(bulk.findRow("id", "12") == 2);  // Still sorted -> binary search
+  assert(bulk.findRow("sensor", "Door") == 2);
+
+  // Mixing with the variadic API keeps rows aligned
+  bulk.insertAt(1004, 14, "Door");
+  bulk.deleteOlderThan(1002);
+  assert(bulk.getSize() == 3);
+  bulk.reset();
+  assert(bulk.get<int>(0) == 12);
+
+  // Type mismatch rejects the whole batch
+  SnailBatch bad(1);
+  bad.setStrs(0, sensors);
+  bad.setStrs(1, sensors);
+  assert(!bulk.insertBatch(bad));
+  assert(bulk.getSize() == 3);
+
+  std::cout << "Bulk Insert Verified!" << std::endl;
+
+  // 13. Typed Table
+  std::cout << "Testing Typed Table..." << std::endl;
+  SnailTable<IntCol<IdName>, StrCol<SensorName, 10>> table;
+  table.reserve(4);
+  table.insertAt(100, 1, "Temp");
+  table.insertAt(200, 2, std::string("Door"));
+  table.insertAt(300, 3, "Temp");
+  // table.insert(4);          // Does not compile: wrong arity
+  // table.insert("x", "y");   // Does not compile: wrong type for 'id'
+  // table.insert((int64_t)4, "x"); // Does not compile: narrows into INT
+  static_assert(IntCol<IdName>::accepts<short>::value && IntCol<IdName>::accepts<uint16_t>::value,
+                "IntCol takes integers that fit in int");
+  static_assert(!IntCol<IdName>::accepts<int64_t>::value &&
+                    !IntCol<IdName>::accepts<uint32_t>::value &&
+                    !IntCol<IdName>::accepts<size_t>::value && !IntCol<IdName>::accepts<bool>::value,
+                "IntCol rejects narrowing integer types");
+  static_assert(Int64Col<IdName>::accepts<int>::value &&
+                    Int64Col<IdName>::accepts<uint32_t>::value &&
+                    FloatCol<TempName>::accepts<float>::value &&
+                    FloatCol<TempName>::accepts<short>::value &&
+                    DoubleCol<TempName>::accepts<float>::value &&
+                    DoubleCol<TempName>::accepts<int>::value,
+                "NumCol takes values its type holds exactly");
+  static_assert(!Int64Col<IdName>::accepts<double>::value &&
+                    !Int64Col<IdName>::accepts<uint64_t>::value &&
+                    !FloatCol<TempName>::accepts<double>::value &&
+                    !FloatCol<TempName>::accepts<int64_t>::value &&
+                    !FloatCol<TempName>::accepts<int>::value &&
+                    !DoubleCol<TempName>::accepts<int64_t>::value &&
+                    !DoubleCol<TempName>::accepts<bool>::value,
+                "NumCol rejects narrowing types");
+  assert(table.getSize() == 3);
+  assert(table.get<0>(1) == 2);
+  assert(table.get<1>(2) == "Temp");
+  assert(table.findRow<0>(3) == 2);
+  assert(table.findRow<1>(std::string("Door")) == 1);
+
+  table.deleteOlderThan(150);
+  table.purge();
+  assert(table.getSize() == 2);
+  assert(table.col<0>().isSorted());
+
+  // Typed tables and SnailDB share the file format
+  assert(SnailStorage::save(table, "table.snail"));
+  SnailDB fromTable;
+  assert(SnailStorage::load(fromTable, "table.snail"));
+  assert(fromTable.getSize() == 2);
+  assert(fromTable.findRow("sensor", "Temp") == 1);
+
+  SnailTable<IntCol<IdName>, StrCol<SensorName, 10>> reloaded;
+  assert(SnailStorage::load(reloaded, "table.snail"));
+  assert(reloaded.get<1>(0) == "Door");
+  SnailTable<StrCol<SensorName, 10>, IntCol<IdName>> wrongSchema;
+  assert(!SnailStorage::load(wrongSchema, "table.snail"));
+
+  std::cout << "Typed Table Verified!" << std::endl;
+
+  // 14. Prepared Lookups
+  std::cout << "Testing Prepared Lookups..." << std::endl;
+  SnailDB prep;
+  prep.addIntColProp("id", 0);
+  prep.addStrColProp("sensor", 10);
+  prep.insert(5, "Temp");
+  prep.insert(3, "Door");
+  prep.insert(9, "Temp");
+
+  SnailColumnHandle idCol = prep.prepareColumn("id");
+  assert(idCol.getColIndex() == 0);
+  assert(prep.findRow(idCol, 9) == 2); // Unsorted -> scan
+  prep.createIndex();
+  assert(prep.findRow(idCol, 3) == 1); // Hash index
+  assert(prep.findRow(idCol, 4) == -1);
+
+  SnailPredicate window = prep.prepare("sensor", "Window");
+  assert(prep.findRow(window) == -1); // Not in dictionary yet
+  prep.insert(7, "Window");           // Dictionary change re-resolves
+  assert(prep.findRow(window) == 3);
+  window.setValue("Door");
+  assert(prep.findRow(window) == 1);
+  prep.softDelete(1);
+  assert(prep.findRow(window) == -1);
+
+  // Schema change (load) re-resolves handles by name
+  assert(SnailStorage::save(prep, "prep.snail"));
+  assert(SnailStorage::load(prep, "prep.snail"));
+  assert(prep.findRow(idCol, 7) == 3);
+
+  // Same schema epoch on another table: the handle follows the table it is
+  // used with, not the one it was prepared on
+  SnailDB left, right;
+  left.addIntColProp("id", 0);
+  left.addStrColProp("sensor", 10);
+  right.addStrColProp("sensor", 10);
+  right.addIntColProp("id", 0);
+  left.insert(1, "Temp");
+  right.insert("Door", 2);
+  right.insert("Temp", 1);
+  SnailColumnHandle leftId = left.prepareColumn("id");
+  assert(right.findRow(leftId, 1) == 1 && leftId.getColIndex() == 1);
+  assert(left.findRow(leftId, 1) == 0 && leftId.getColIndex() == 0);
+  SnailPredicate temp = left.prepare("sensor", "Temp");
+  assert(right.findRow(temp) == 1 && left.findRow(temp) == 0);
+
+  std::cout << "Prepared Lookups Verified!" << std::endl;
+
+  // 15. Native Numeric Types
+  std::cout << "Testing Native Types..." << std::endl;
+  SnailDB tele;
+  tele.addInt64ColProp("counter", 0);
+  tele.addFloatColProp("temp", 0);
+  tele.addDoubleColProp("energy", 0);
+  tele.addBoolColProp("alarm", 0);
+
+  const int64_t big = 5000000000LL; // Does not fit in 32 bits
+  tele.insertAt(10, big, 21.5f, 0.125, false);
+  tele.insertAt(20, big + 1, 22.0f, 1.5, true);
+  tele.insertAt(30, big + 2, 20.5, 3, false); // Converted to column types
+
+  const int64_t counters[] = {big + 3, big + 4};
+  const float temps[] = {19.0f, 23.25f};
+  const double energy[] = {4.0, 5.0};
+  const bool alarms[] = {true, false};
+  SnailBatch numBatch(2);
+  numBatch.setInt64s(0, counters);
+  numBatch.setFloats(1, temps);
+  numBatch.setDoubles(2, energy);
+  numBatch.setBools(3, alarms);
+  numBatch.setTimestamp(40);
+  assert(tele.insertBatch(numBatch));
+  assert(tele.getSize() == 5);
+
+  assert(tele.findRow("counter", "5000000002") == 2);
+  assert(tele.findRow("temp", "23.25") == 4);
+  assert(tele.findRow("alarm", "true") == 1);
+  SnailColumnHandle energyCol = tele.prepareColumn("energy");
+  assert(tele.findRow(energyCol, 3.0) == 2);
+
+  tele.softDelete(1);
+  tele.purge();
+  assert(tele.findRow("alarm", "true") == 2); // Bits moved with the rows
+  tele.reset();
+  assert(tele.get<int64_t>(0) == big);
+  assert(tele.get<float>(1) == 21.5f);
+  assert(tele.get<int>(1) == 21); // Converted like get<int64_t>
+  SnailOrder teleOrder(tele);
+  assert(teleOrder.orderBy("temp", true, 1));
+  teleOrder.reset();
+  assert(teleOrder.get<int>(1) == (int)teleOrder.get<float>(1) && teleOrder.get<int>(1) != 0);
+
+  assert(SnailStorage::save(tele, "tele.snail"));
+  SnailDB teleLoaded;
+  assert(SnailStorage::load(teleLoaded, "tele.snail"));
+  assert(teleLoaded.getSize() == 4);
+  assert(teleLoaded.getColType(3) == BOOL_TYPE);
+  teleLoaded.tail();
+  assert(teleLoaded.get<int64_t>(0) == big + 4);
+  assert(teleLoaded.get<double>(2) == 5.0);
+  assert(!teleLoaded.get<bool>(3));
+  teleLoaded.previous();
+  assert(teleLoaded.get<bool>(3));
+  SnailDumper::printTable(teleLoaded);
+
+  SnailTable<FloatCol<TempName>, BoolCol<AlarmName>> typedTele;
+  typedTele.insert(18.5f, false);
+  typedTele.insert(30.0f, true);
+  assert(typedTele.get<1>(1));
+  assert(SnailStorage::save(typedTele, "typed_tele.snail"));
+  SnailDB typedTeleLoaded;
+  assert(SnailStorage::load(typedTeleLoaded, "typed_tele.snail"));
+  assert(typedTeleLoaded.findRow("temp", "30") == 1);
+  assert(typedTeleLoaded.findRow("alarm", "1") == 1);
+
+  // A NaN is unordered: the column must fall back to scanning
+  SnailDB nanCol;
+  nanCol.addDoubleColProp("v", 0);
+  nanCol.insert(1.0);
+  nanCol.insert(std::numeric_limits<double>::quiet_NaN());
+  nanCol.insert(0.5);
+  assert(nanCol.findRow("v", "0.5") == 2);
+  assert(SnailStorage::save(nanCol, "nan.snail"));
+  SnailDB nanLoaded;
+  assert(SnailStorage::load(nanLoaded, "nan.snail"));
+  assert(nanLoaded.findRow("v", "0.5") == 2);
+
+  // Loaded INT columns keep binary search when their data is sorted
+  SnailDB seqCol;
+  seqCol.addIntColProp("seq", 0);
+  for (int i = 0; i < 10; ++i) seqCol.insert(i * 2);
+  assert(SnailStorage::save(seqCol, "seq.snail"));
+  SnailDB seqLoaded;
+  assert(SnailStorage::load(seqLoaded, "seq.snail"));
+#if SNAILDB_STATS
+  uint32_t seqBinary = SnailStats::instance().findBinary;
+  assert(seqLoaded.findRow("seq", "14") == 7);
+  assert(SnailStats::instance().findBinary == seqBinary + 1);
+#else
+  assert(seqLoaded.findRow("seq", "14") == 7);
+#endif
+
+  // An unknown column type leaves the target table untouched
+  {
+    std::fstream patch("seq.snail", std::ios::in | std::ios::out | std::ios::binary);
+    patch.seekp(12); // Type byte of the first schema entry
+    patch.put((char)0x7F);
+  }
+  assert(!SnailStorage::load(seqLoaded, "seq.snail"));
+  assert(seqLoaded.getColCount() == 1 && seqLoaded.getSize() == 10);
+  assert(seqLoaded.findRow("seq", "14") == 7);
+
+  std::cout << "Native Types Verified!" << std::endl;
+
+  // 16. Parallel Executor
+  std::cout << "Testing Parallel Executor..." << std::endl;
+  SnailDB wide;
+  wide.addIntColProp("id", 0);
+  wide.addStrColProp("sensor", 10);
+  wide.addDoubleColProp("value", 0);
+  for (int i = 0; i < 1000; ++i) {
+    wide.insertAt((uint32_t)i, i, (i % 4 == 0) ? "Door" : "Temp", i * 0.5);
+  }
+
+  SnailThreadPool pool(4);
+  SnailExecutor exec(pool, 64); // Small morsels: many tasks to steal
+  assert(exec.count(wide) == 1000);
+
+  SnailPredicate doors = wide.prepare("sensor", "Door");
+  std::vector<uint32_t> doorRows = exec.filter(wide, doors);
+  assert(doorRows.size() == 250);
+  assert(doorRows[0] == 0 && doorRows[1] == 4 && doorRows[249] == 996);
+
+  SnailAggregate agg;
+  assert(exec.aggregate(wide, "value", agg));
+  assert(agg.count == 1000 && agg.min == 0.0 && agg.max == 499.5);
+  assert(agg.sum == 249750.0);
+  assert(!exec.aggregate(wide, "sensor", agg));
+
+  exec.deleteOlderThan(wide, 100);
+  assert(exec.count(wide) == 900 && wide.getSize() == 900);
+  assert(exec.countWhere(wide, doors) == 225);
+  exec.purge(wide);
+  assert(wide.getSize() == 900);
+  assert(wide.findRow("id", "100") == 0);
+  assert(exec.filter(wide, doors)[0] == 0);
+
+  std::cout << "Parallel Executor Verified!" << std::endl;
+
+  // 17. Memory Accounting
+  std::cout << "Testing Memory Accounting..." << std::endl;
+  SnailDB mem;
+  mem.addIntColProp("id", 0);
+  mem.addStrColProp("sensor", 10);
+  mem.addBoolColProp("alarm", 0);
+  mem.reserve(100);
+  for (int i = 0; i < 10; ++i) {
+    mem.insertAt((uint32_t)i, i, (i % 2) ? "Temp_Sensor_Long_Name" : "Door", i == 3);
+  }
+
+  SnailMemoryStats idStats = mem.getColMemoryStats(0);
+  assert(idStats.storage.used == 10 * sizeof(int));
+  assert(idStats.storage.reserved == 100 * sizeof(int));
+  assert(idStats.index.used == 0);
+  mem.insert(-1, "Door", false); // Unsorted, so an index is worth building
+  mem.createIndex();
+  assert(mem.getColMemoryStats(0).index.used == 11 * sizeof(IndexEntry));
+
+  SnailMemoryStats sensorStats = mem.getColMemoryStats(1);
+  assert(sensorStats.tokens.used == 11 * sizeof(uint16_t));
+  assert(sensorStats.dictionary.used >= 2 * sizeof(std::string));
+  assert(mem.getColMemoryStats(2).storage.used == 2); // 11 bits -> 2 bytes
+
+  SnailMemoryStats total = mem.getMemoryStats();
+  assert(total.timestamps.used == 11 * sizeof(uint32_t));
+  assert(total.tombstones.used == 2);
+  assert(total.totalUsed() <= total.totalReserved());
+  SnailDumper::printStats(mem);
+
+  // Per-row inserts are counted but not timed; batches are timed
+  assert(SnailStats::enabled() == (SNAILDB_STATS != 0));
+  if (SnailStats::enabled()) {
+    SnailStats &st = SnailStats::instance();
+    uint32_t rowsBefore = st.rowsInserted, timedBefore = st.insertTime.count;
+    mem.insert(7, "Door", true);
+    assert(st.rowsInserted == rowsBefore + 1 && st.insertTime.count == timedBefore);
+    const int ids[] = {8, 9};
+    const char *sensors[] = {"Door", "Door"};
+    const bool alarms[] = {false, true};
+    SnailBatch statBatch(2);
+    statBatch.setInts(0, ids);
+    statBatch.setStrs(1, sensors);
+    statBatch.setBools(2, alarms);
+    assert(mem.insertBatch(statBatch));
+    assert(st.rowsInserted == rowsBefore + 3 && st.insertTime.count == timedBefore + 1);
+  }
+
+  std::cout << "Memory Accounting Verified!" << std::endl;
+
+  // 18. String Range Queries
+  std::cout << "Testing String Range Queries..." << std::endl;
+  SnailDB names;
+  names.addStrColProp("city", 16, true); // Ordered dictionary
+  names.addIntColProp("pop", 0);
+  const char *cities[] = {"Paris", "Berlin", "Bern", "Oslo", "Berlin", "Madrid"};
+  for (int i = 0; i < 6; ++i) names.insert(cities[i], i);
+
+  SnailPredicate osloPred = names.prepare("city", "Oslo");
+  assert(names.findRow(osloPred) == 3);
+
+  // Unordered dictionary: evaluated once per distinct string
+  std::vector<uint32_t> bRows = names.findPrefix("city", "Ber");
+  assert(bRows.size() == 3 && bRows[0] == 1 && bRows[1] == 2 && bRows[2] == 4);
+  assert(names.findLessThan("city", "Madrid").size() == 3);
+
+  names.createIndex(); // Sorts the dictionary and remaps the tokens
+  assert(names.findRow(osloPred) == 3); // Re-resolved after the remap
+  names.reset();
+  assert(names.get<std::string>(0) == "Paris");
+  assert(names.get<int>(1) == 0);
+
+  std::vector<uint32_t> mid = names.findBetween("city", "Bern", "Oslo");
+  assert(mid.size() == 3 && mid[0] == 2 && mid[1] == 3 && mid[2] == 5);
+  assert(names.findPrefix("city", "Ber").size() == 3);
+  assert(names.findPrefix("city", "Z").empty());
+  assert(names.findLessThan("city", "Berlin").empty());
+
+  names.softDelete(1);
+  assert(names.findPrefix("city", "Berl").size() == 1); // Tombstones skipped
+
+  // Sorted tokens: the range is a contiguous span of rows
+  SnailDB sortedNames;
+  sortedNames.addStrColProp("code", 4, true);
+  const char *codes[] = {"AA", "AB", "AB", "BA", "CA"};
+  for (int i = 0; i < 5; ++i) sortedNames.insert(codes[i]);
+  std::vector<uint32_t> aRows = sortedNames.findPrefix("code", "A");
+  assert(aRows.size() == 3 && aRows[2] == 2);
+  assert(sortedNames.findRow("code", "BA") == 3);
+
+  // The ordered-dictionary flag is part of the schema
+  assert(names.hasOrderedDictionary(0) && !names.hasOrderedDictionary(1));
+  assert(SnailStorage::save(names, "names.snail"));
+  SnailDB namesLoaded;
+  assert(SnailStorage::load(namesLoaded, "names.snail"));
+  assert(namesLoaded.hasOrderedDictionary(0) && !namesLoaded.hasOrderedDictionary(1));
+  namesLoaded.insert("Aachen", 6);
+  namesLoaded.createIndex(); // Still sorts the dictionary
+  assert(namesLoaded.findLessThan("city", "Berlin").size() == 1);
+  {
+    std::ofstream bin("names_export.snail", std::ios::binary);
+    assert(SnailExporter(names).writeBinary(bin));
+  }
+  SnailDB namesExported;
+  assert(SnailStorage::load(namesExported, "names_export.snail"));
+  assert(namesExported.hasOrderedDictionary(0));
+
+  SnailJoinResult namePairs;
+  SnailJoin selfJoin(names, "city", namesLoaded, "city");
+  assert(selfJoin.run(namePairs));
+  std::vector<std::string> cityCol, noCols;
+  cityCol.push_back("city");
+  SnailDB namesJoined;
+  assert(selfJoin.materialize(namePairs, cityCol, noCols, namesJoined));
+  assert(namesJoined.hasOrderedDictionary(0));
+
+  std::cout << "String Range Queries Verified!" << std::endl;
+
+  // 19. Incremental Indexes
+  std::cout << "Testing Incremental Indexes..." << std::endl;
+  SnailDB inc;
+  inc.addIntColProp("id", 0);
+  inc.addStrColProp("tag", 8);
+  inc.addIntColProp("seq", 0); // Stays sorted
+  for (int i = 0; i < 100; ++i) {
+    inc.insert((i * 37) % 101, (i % 3) ? "odd" : "even", i);
+  }
+  inc.createIndex();
+
+  // Appends go through the delta buffer, no rebuild needed
+  for (int i = 100; i < 300; ++i) {
+    inc.insert(1000 + (300 - i), (i == 250) ? "late" : "odd", i);
+  }
+  assert(inc.getColMemoryStats(0).index.used == 300 * sizeof(IndexEntry));
+  assert(inc.getColMemoryStats(1).index.used == 300 * sizeof(IndexEntry));
+  assert(inc.findRow("id", "1100") == 200);
+  assert(inc.findRow("id", "1001") == 299); // Still in the delta
+  assert(inc.findRow("tag", "late") == 250);
+  assert(inc.findRow("id", "37") == 1);
+
+  // Purge remaps row ids instead of dropping the index
+  for (int i = 0; i < 300; i += 2) inc.softDelete(i);
+  inc.purge();
+  assert(inc.getSize() == 150);
+  assert(inc.getColMemoryStats(0).index.used == 150 * sizeof(IndexEntry));
+  assert(inc.findRow("id", "37") == 0);    // Old row 1
+  assert(inc.findRow("id", "1100") == -1); // Old row 200 (deleted)
+  assert(inc.findRow("id", "1099") == 100); // Old row 201
+  assert(inc.findRow("tag", "late") == -1);
+  assert(inc.findRow("tag", "even") == 1);  // Old row 3
+
+  // Index runs are ordered by (hash, row): matches come out in row order
+  SnailQuery oddQuery(inc);
+  SnailQueryResult oddRows;
+  assert(oddQuery.where("tag", OP_EQ, "odd").run(oddRows) && oddRows.size() > 100);
+  for (size_t i = 1; i < oddRows.size(); ++i) {
+    assert(oddRows.getRowId(i) > oddRows.getRowId(i - 1));
+  }
+
+#if SNAILDB_STATS
+  uint32_t binaryBefore = SnailStats::instance().findBinary;
+  assert(inc.findRow("seq", "201") == 100);
+  assert(SnailStats::instance().findBinary == binaryBefore + 1); // Still sorted
+#else
+  assert(inc.findRow("seq", "201") == 100);
+#endif
+  inc.insert(5, "new", 300);
+  assert(inc.findRow("id", "5") == 150);
+  assert(inc.findRow("tag", "new") == 150);
+
+  std::cout << "Incremental Indexes Verified!" << std::endl;
+
+  // 20. Query Pipeline
+  std::cout << "Testing Query Pipeline..." << std::endl;
+  SnailDB readings;
+  readings.addStrColProp("sensor", 8);
+  readings.addDoubleColProp("value", 0);
+  readings.addIntColProp("zone", 0);
+  const char *sensorNames[] = {"Temp", "Hum", "Door"};
+  for (int i = 0; i < 1000; ++i) {
+    readings.insertAt((uint32_t)(1000 + i), sensorNames[i % 3], (double)(i % 100), i % 7);
+  }
+  readings.softDelete(3); // Temp, value 3, ts 1003
+
+  SnailQueryResult qr;
+  SnailQuery q(readings);
+  q.where("sensor", OP_EQ, "Temp").where("value", OP_GT, "50").whereTime(1000, 1199);
+  q.select("value").select("sensor");
+  assert(q.run(qr));
+
+  // Reference result by hand
+  size_t expected = 0;
+  for (int i = 0; i < 200; ++i) {
+    if (i % 3 == 0 && i % 100 > 50) expected++;
+  }
+  assert(qr.size() == expected);
+  assert(qr.getColCount() == 2 && qr.getColName(0) == "value");
+  for (size_t i = 0; i < qr.size(); ++i) {
+    assert(qr.getDouble(i, 0) > 50.0);
+    assert(qr.getStr(i, 1) == "Temp");
+    assert(qr.getRowId(i) < 200);
+  }
+  // Time range is a binary-searched span, evaluated first
+  assert(qr.getPlan().size() == 3);
+  assert(qr.getPlan()[0].path == PATH_TIME_RANGE && qr.getPlan()[0].estimate == 200);
+  assert(qr.getPlan()[1].column == "sensor");
+  assert(qr.getPlan()[1].estimate == 333); // One of three dictionary entries
+
+  // Missing dictionary value: no rows touched
+  SnailQuery none(readings);
+  none.where("sensor", OP_EQ, "Wind").where("zone", OP_EQ, "1");
+  assert(none.run(qr) && qr.size() == 0);
+  assert(qr.getPlan()[0].path == PATH_EMPTY);
+
+  // Indexed equality seeds the selection; tombstones are skipped
+  readings.createIndex();
+  SnailQuery byZone(readings);
+  byZone.where("zone", OP_EQ, "3").where("sensor", OP_NE, "Door").whereBetween("value", "0", "9");
+  assert(byZone.run(qr));
+  assert(qr.getPlan()[0].path == PATH_INDEX);
+  size_t zoneExpected = 0;
+  for (int i = 0; i < 1000; ++i) {
+    if (i != 3 && i % 7 == 3 && i % 3 != 2 && i % 100 <= 9) zoneExpected++;
+  }
+  assert(qr.size() == zoneExpected);
+  assert(qr.getColCount() == 3); // No projection: every column
+  for (size_t i = 0; i < qr.size(); ++i) {
+    assert(qr.getInt(i, 2) == 3 && qr.getStr(i, 0) != "Door");
+  }
+
+  SnailQuery badOp(readings);
+  badOp.where("value", OP_PREFIX, "1");
+  assert(!badOp.run(qr));
+  SnailQuery missing(readings);
+  missing.where("nope", OP_EQ, "1");
+  assert(!missing.run(qr));
+
+  std::cout << "Query Pipeline Verified!" << std::endl;
+
+  // 21. Ordered Views / Top-K
+  std::cout << "Testing Top-K..." << std::endl;
+  SnailDB alerts;
+  alerts.addStrColProp("sensor", 8);
+  alerts.addFloatColProp("temp", 0);
+  const char *alertNames[] = {"Kitchen", "Attic", "Cellar", "Garage"};
+  for (int i = 0; i < 200; ++i) {
+    alerts.insert(alertNames[i % 4], (float)((i * 53) % 200) / 2.0f);
+  }
+  // (i * 53) % 200 is a permutation: every temp 0.0 .. 99.5 occurs once
+  alerts.softDelete(0); // Coolest reading
+  int hottest = 0;
+  for (int i = 0; i < 200; ++i) {
+    if ((i * 53) % 200 == 199) hottest = i;
+  }
+  alerts.softDelete((size_t)hottest);
+
+  SnailOrder top(alerts);
+  assert(top.orderBy("temp", false, 3));
+  assert(top.size() == 3);
+  top.reset();
+  assert(top.get<float>(1) == 99.0f); // 199 / 2 is tombstoned
+  top.next();
+  assert(top.get<float>(1) == 98.5f);
+  top.next();
+  assert(top.get<float>(1) == 98.0f);
+  top.next();
+  assert(!top.valid());
+
+  // Full sort agrees with the top-K prefix
+  SnailOrder all(alerts);
+  assert(all.orderBy("temp", false));
+  assert(all.size() == 198);
+  for (size_t k = 0; k < 3; ++k) assert(all.getRowId(k) == top.getRowId(k));
+  float prev = 1000.0f;
+  for (all.reset(); all.valid(); all.next()) {
+    float t = all.get<float>(1);
+    assert(t <= prev);
+    prev = t;
+  }
+
+  // Strings: lexical order from dictionary ranks, ties by row id
+  SnailOrder byName(alerts);
+  assert(byName.orderBy("sensor", true, 5));
+  byName.reset();
+  assert(byName.get<std::string>(0) == "Attic");
+  assert(byName.getRowId(0) == 1 && byName.getRowId(1) == 5);
+  byName.tail();
+  assert(byName.getCursor() == 4 && byName.get<std::string>(0) == "Attic");
+
+  // Subset from a query, lowest first
+  SnailQuery cellar(alerts);
+  cellar.where("sensor", OP_EQ, "Cellar");
+  assert(cellar.run(qr));
+  SnailOrder coolest(alerts);
+  assert(coolest.orderBy("temp", qr.getRowIds(), true, 2));
+  assert(coolest.size() == 2);
+  coolest.reset();
+  assert(coolest.get<std::string>(0) == "Cellar");
+  assert(!coolest.orderBy("nope"));
+
+  // NaN keys sort last both ways: the comparator stays a strict weak order
+  SnailDB nanVals;
+  nanVals.addDoubleColProp("v", 0);
+  for (int i = 0; i < 300; ++i) {
+    nanVals.insert(i % 7 == 0 ? std::numeric_limits<double>::quiet_NaN()
+                              : (double)((i * 37) % 101));
+  }
+  for (int dir = 0; dir < 2; ++dir) {
+    SnailOrder nanOrder(nanVals);
+    assert(nanOrder.orderBy("v", dir == 0));
+    assert(nanOrder.size() == 300);
+    bool inNan = false;
+    double prevVal = 0;
+    for (nanOrder.reset(); nanOrder.valid(); nanOrder.next()) {
+      double v = nanOrder.get<double>(0);
+      if (std::isnan(v)) {
+        inNan = true;
+        continue;
+      }
+      assert(!inNan);
+      if (nanOrder.getCursor() > 0) assert(dir == 0 ? v >= prevVal : v <= prevVal);
+      prevVal = v;
+    }
+  }
+  SnailOrder nanTop(nanVals);
+  assert(nanTop.orderBy("v", false, 3));
+  nanTop.reset();
+  for (int i = 0; i < 3; ++i, nanTop.next()) assert(nanTop.get<double>(0) == 100.0);
+
+  std::cout << "Top-K Verified!" << std::endl;
+
+  // 22. Hash Join
+  std::cout << "Testing Hash Join..." << std::endl;
+  SnailDB devices;
+  devices.addIntColProp("device", 0);
+  devices.addStrColProp("room", 8);
+  devices.addStrColProp("model", 8);
+  devices.insert(7, "Hall", "TH-1");
+  devices.insert(3, "Lab", "TH-2");
+  devices.insert(9, "Roof", "WX-9");
+  devices.insert(3, "Lab2", "TH-2"); // Duplicate key: both rows match
+
+  SnailDB samples;
+  samples.addInt64ColProp("device", 0);
+  samples.addStrColProp("model", 8);
+  samples.addFloatColProp("temp", 0);
+  const char *sampleModels[] = {"TH-2", "XX-0", "TH-1"};
+  for (int i = 0; i < 600; ++i) {
+    int dev = (i % 4 == 0) ? 3 : (i % 4 == 1) ? 7 : (i % 4 == 2) ? 5 : 9;
+    samples.insertAt((uint32_t)i, (int64_t)dev, sampleModels[i % 3], (float)i);
+  }
+  samples.softDelete(1); // Device 7
+
+  SnailJoin join(samples, "device", devices, "device"); // INT64 x INT
+  SnailJoinResult pairs;
+  assert(join.run(pairs));
+  // 150 rows of device 3 (two matches each), 149 of 7, 150 of 9, none of 5
+  assert(pairs.size() == 300 + 149 + 150);
+  for (size_t i = 0; i < pairs.size(); ++i) {
+    assert(pairs.left[i] != 1 && pairs.left[i] % 4 != 2);
+    if (i > 0) assert(pairs.left[i] >= pairs.left[i - 1]); // Probe order
+  }
+  assert(pairs.left[0] == 0 && pairs.right[0] == 1 && pairs.right[1] == 3);
+
+  // Dictionary keys: token-to-token map, no string compares per row
+  SnailJoin byModel(devices, "model", samples, "model");
+  assert(byModel.run(pairs));
+  size_t modelExpected = 0;
+  for (int i = 0; i < 600; ++i) {
+    if (i == 1) continue;
+    if (i % 3 == 0) modelExpected += 2; // TH-2: devices 3 and 3
+    if (i % 3 == 2) modelExpected += 1; // TH-1
+  }
+  assert(pairs.size() == modelExpected);
+
+  SnailDB joined;
+  assert(join.run(pairs));
+  std::vector<std::string> leftCols, rightCols;
+  leftCols.push_back("temp");
+  rightCols.push_back("room");
+  assert(join.materialize(pairs, leftCols, rightCols, joined));
+  assert(joined.getSize() == pairs.size() && joined.getColCount() == 2);
+  assert(joined.findRow("room", "Roof") == 2);
+  joined.reset();
+  assert(joined.get<float>(0) == 0.0f && joined.get<std::string>(1) == "Lab");
+  joined.next();
+  assert(joined.get<std::string>(1) == "Lab2");
+
+  SnailJoin badKey(samples, "temp", devices, "device");
+  assert(!badKey.run(pairs));
+
+  std::cout << "Hash Join Verified!" << std::endl;
+
+  // 23. Streaming Exporters
+  std::cout << "Testing Exporters..." << std::endl;
+  SnailDB exp;
+  exp.addIntColProp("id", 0);
+  exp.addStrColProp("note", 16);
+  exp.addFloatColProp("temp", 0);
+  exp.addInt64ColProp("big", 0);
+  exp.addBoolColProp("ok", 0);
+  exp.insertAt(100, -42, "plain", 21.5f, (int64_t)-9000000000LL, true);
+  exp.insertAt(101, 0, "a,b \"q\"", 0.1f, (int64_t)7, false);
+  exp.insertAt(102, 1234567, "gone", 3.0f, (int64_t)0, true);
+  exp.insertAt(103, 9, "line\nbreak", -1.25f, (int64_t)1, false);
+  exp.softDelete(2);
+
+  std::ostringstream csv;
+  SnailExporter csvOut(exp, 16); // Tiny buffer: exercises the flushes
+  assert(csvOut.withTimestamps().writeCsv(csv));
+  assert(csvOut.getRowsWritten() == 3);
+  assert(csv.str() == "ts,id,note,temp,big,ok\n"
+                      "100,-42,plain,21.5,-9000000000,true\n"
+                      "101,0,\"a,b \"\"q\"\"\",0.1,7,false\n"
+                      "103,9,\"line\nbreak\",-1.25,1,false\n");
+
+  std::ostringstream jsonl;
+  SnailExporter jsonOut(exp);
+  std::vector<uint32_t> picked;
+  picked.push_back(3);
+  picked.push_back(2); // Tombstoned: skipped
+  picked.push_back(1);
+  assert(jsonOut.select("note").select("ok").rows(picked).writeJsonLines(jsonl));
+  assert(jsonl.str() == "{\"note\":\"line\\nbreak\",\"ok\":false}\n"
+                        "{\"note\":\"a,b \\\"q\\\"\",\"ok\":false}\n");
+  assert(!SnailExporter(exp).select("nope").writeCsv(jsonl));
+
+  // Binary export uses the .snail layout
+  {
+    std::ofstream bin("export.snail", std::ios::binary);
+    SnailExporter binOut(exp);
+    assert(binOut.select("ok").select("note").select("big").writeBinary(bin));
+  }
+  SnailDB imported;
+  assert(SnailStorage::load(imported, "export.snail"));
+  assert(imported.getSize() == 3 && imported.getColCount() == 3);
+  assert(imported.getColType(0) == BOOL_TYPE);
+  imported.tail();
+  assert(!imported.get<bool>(0) && imported.get<std::string>(1) == "line\nbreak");
+  assert(imported.get<int64_t>(2) == 1);
+  imported.reset();
+  assert(imported.get<bool>(0) && imported.get<int64_t>(2) == -9000000000LL);
+
+  // Whole floats keep a ".0" (and -0.0 its sign): they read back as floats
+  SnailDB whole;
+  whole.addDoubleColProp("v", 0);
+  whole.insert(2.0);
+  whole.insert(-0.0);
+  whole.insert(-3.0);
+  std::ostringstream wholeCsv;
+  assert(SnailExporter(whole).writeCsv(wholeCsv));
+  assert(wholeCsv.str() == "v\n2.0\n-0.0\n-3.0\n");
+  SnailDB wholeBack;
+  SnailImporter wholeIn(wholeBack);
+  assert(wholeIn.importBuffer(wholeCsv.str().data(), wholeCsv.str().size(), IMPORT_CSV));
+  assert(wholeBack.getColType(0) == DOUBLE_TYPE);
+  wholeBack.reset();
+  wholeBack.next();
+  assert(wholeBack.get<double>(0) == 0.0 && std::signbit(wholeBack.get<double>(0)));
+
+  std::cout << "Exporters Verified!" << std::endl;
+
+  // 24. Bulk Importer
+  std::cout << "Testing Importer..." << std::endl;
+  // Schema inferred from the exporter's CSV; "ts" fills the timestamps
+  SnailDB back;
+  SnailImporter csvIn(back);
+  assert(csvIn.importBuffer(csv.str().data(), csv.str().size(), IMPORT_CSV));
+  assert(csvIn.getRowsImported() == 3 && back.getColCount() == 5);
+  assert(back.getColType(0) == INT_TYPE && back.getColType(1) == STR_TYPE);
+  assert(back.getColType(2) == DOUBLE_TYPE && back.getColType(3) == INT64_TYPE);
+  assert(back.getColType(4) == BOOL_TYPE);
+  assert(back.findRow("note", "a,b \"q\"") == 1);
+  assert(back.findRow("note", "line\nbreak") == 2);
+  assert(back.findRow("big", "-9000000000") == 0);
+  SnailQueryResult atTs;
+  SnailQuery tsQuery(back);
+  assert(tsQuery.whereTime(103, 103).run(atTs) && atTs.size() == 1 && atTs.getRowId(0) == 2);
+  assert(!back.hasOrderedDictionary(1));
+  SnailDB backOrdered;
+  SnailImporter orderedIn(backOrdered);
+  orderedIn.setOrderedDictionaries(true);
+  assert(orderedIn.importBuffer(csv.str().data(), csv.str().size(), IMPORT_CSV));
+  assert(backOrdered.hasOrderedDictionary(1) && !backOrdered.hasOrderedDictionary(0));
+
+  // Existing schema: matched by name, dictionary entries merged into the
+  // column's, keys in any order
+  SnailDB known;
+  known.addStrColProp("note", 16);
+  known.addBoolColProp("ok", 0);
+  known.insert("a,b \"q\"", true);
+  SnailImporter jsonIn(known);
+  const std::string objects = "{\"note\":\"line\\nbreak\",\"ok\":false}\n"
+                              "\n"
+                              "{ \"ok\" : true, \"note\" : \"a,b \\\"q\\\"\" }\n"
+                              "{\"note\":\"\\u00e9t\\u00e9\",\"ok\":true}";
+  assert(jsonIn.importBuffer(objects.data(), objects.size(), IMPORT_JSONL));
+  assert(jsonIn.getRowsImported() == 3 && known.getSize() == 4);
+  assert(known.findRow("note", "line\nbreak") == 1);
+  assert(known.findRow("note", "\xc3\xa9t\xc3\xa9") == 3);
+  known.reset();
+  known.next();
+  known.next();
+  assert(known.get<std::string>(0) == "a,b \"q\"" && known.get<bool>(1));
+  assert(known.findRow("note", "a,b \"q\"") == 0); // One dictionary entry
+
+  // Parallel parse: tiny chunks split records (and quoted line breaks)
+  // across many tasks; the result matches the source row for row
+  SnailDB src;
+  src.addIntColProp("id", 0);
+  src.addStrColProp("tag", 16);
+  src.addDoubleColProp("v", 0);
+  for (int i = 0; i < 2000; ++i) {
+    std::string tag = (i % 7 == 0) ? "multi\nline" : "tag" + std::to_string(i % 13);
+    src.insertAt((uint32_t)(i / 3), i, tag, i * 0.25);
+  }
+  std::ostringstream srcCsv;
+  std::ostringstream srcJson;
+  assert(SnailExporter(src).withTimestamps().writeCsv(srcCsv));
+  assert(SnailExporter(src).withTimestamps().writeJsonLines(srcJson));
+
+  SnailDB par;
+  SnailImporter parIn(par, &pool, 256);
+  assert(parIn.importBuffer(srcCsv.str().data(), srcCsv.str().size(), IMPORT_CSV));
+  assert(parIn.getRowsImported() == 2000);
+  std::ostringstream parCsv;
+  assert(SnailExporter(par).withTimestamps().writeCsv(parCsv));
+  assert(parCsv.str() == srcCsv.str());
+
+  SnailDB parJson;
+  SnailImporter parJsonIn(parJson, &pool, 256);
+  assert(parJsonIn.importBuffer(srcJson.str().data(), srcJson.str().size(), IMPORT_JSONL));
+  std::ostringstream parJsonOut;
+  assert(SnailExporter(parJson).withTimestamps().writeJsonLines(parJsonOut));
+  assert(parJsonOut.str() == srcJson.str());
+
+  // Streaming (the MCU path): small reads, records straddle them
+  SnailDB streamed;
+  std::istringstream srcStream(srcCsv.str());
+  SnailImporter streamIn(streamed, nullptr, 64);
+  assert(streamIn.importStream(srcStream, IMPORT_CSV));
+  std::ostringstream streamedCsv;
+  assert(SnailExporter(streamed).withTimestamps().writeCsv(streamedCsv));
+  assert(streamedCsv.str() == srcCsv.str());
+
+  // Files are memory-mapped where available
+  {
+    std::ofstream file("import.csv", std::ios::binary);
+    file << srcCsv.str();
+  }
+  SnailDB mapped;
+  SnailImporter fileIn(mapped, &pool);
+  assert(fileIn.importFile("import.csv", IMPORT_CSV));
+  assert(mapped.getSize() == 2000 && mapped.findRow("tag", "multi\nline") == 0);
+  assert(!SnailImporter(mapped).importFile("missing.csv", IMPORT_CSV));
+
+  // Errors: rows before the bad line are kept; schema must match
+  SnailDB strict;
+  strict.addIntColProp("id", 0);
+  strict.addStrColProp("name", 8);
+  SnailImporter strictIn(strict);
+  const std::string badRow = "name,id\nok,1\nbad,x\nlater,3\n";
+  assert(!strictIn.importBuffer(badRow.data(), badRow.size(), IMPORT_CSV));
+  assert(strictIn.getErrorLine() == 3 && strict.getSize() == 1);
+  const std::string missingCol = "id\n4\n";
+  assert(!strictIn.importBuffer(missingCol.data(), missingCol.size(), IMPORT_CSV));
+  assert(strictIn.getErrorLine() == 1 && strict.getSize() == 1);
+  const std::string badJson = "{\"id\":5,\"name\":\"x\"}\n{\"id\":6,\"name\":[1]}\n";
+  assert(!strictIn.importBuffer(badJson.data(), badJson.size(), IMPORT_JSONL));
+  assert(strictIn.getErrorLine() == 2 && strict.getSize() == 2);
+
+  // Chunk boundaries follow the parser's quoting: any chunk size gives the
+  // same rows, and a bare quote is an error wherever the chunks fall
+  std::string quoted = "name,n\n";
+  for (int i = 0; i < 50; ++i) quoted += "r" + std::to_string(i) + "," + std::to_string(i) + "\n";
+  quoted += "\"multi\nline\",50\n";
+  for (int i = 51; i < 101; ++i) quoted += "r" + std::to_string(i) + "," + std::to_string(i) + "\n";
+  const std::string stray = "name,n\n5\" pipe,1\n" + quoted.substr(7);
+  const size_t chunkSizes[] = {SnailImporter::DEFAULT_CHUNK, 37, 64, 100};
+  std::string firstCsv;
+  for (size_t chunk : chunkSizes) {
+    SnailDB split;
+    SnailImporter splitIn(split, &pool, chunk);
+    assert(splitIn.importBuffer(quoted.data(), quoted.size(), IMPORT_CSV));
+    assert(split.getSize() == 101 && split.findRow("name", "multi\nline") == 50);
+    std::ostringstream splitCsv;
+    assert(SnailExporter(split).writeCsv(splitCsv));
+    if (firstCsv.empty()) firstCsv = splitCsv.str();
+    assert(splitCsv.str() == firstCsv);
+
+    SnailDB strayDb;
+    SnailImporter strayIn(strayDb, &pool, chunk);
+    assert(!strayIn.importBuffer(stray.data(), stray.size(), IMPORT_CSV));
+    assert(strayIn.getErrorLine() == 2 && strayDb.getSize() == 0);
+  }
+
+  // Values past the sample that do not fit widen the inferred column
+  SnailDB wideSrc;
+  wideSrc.addDoubleColProp("d", 0);
+  wideSrc.addInt64ColProp("big", 0);
+  for (int i = 0; i < 300; ++i) {
+    double d = i < 100 ? (double)i : i + 0.5;
+    int64_t big = i < 100 ? i : (int64_t(1) << 31) + i;
+    wideSrc.insertAt((uint32_t)i, d, big);
+  }
+  std::ostringstream wideCsv, wideJson;
+  assert(SnailExporter(wideSrc).withTimestamps().writeCsv(wideCsv));
+  assert(SnailExporter(wideSrc).withTimestamps().writeJsonLines(wideJson));
+  SnailDB wideCsvBack, wideJsonBack, wideStreamed;
+  assert(SnailImporter(wideCsvBack, &pool, 64)
+             .importBuffer(wideCsv.str().data(), wideCsv.str().size(), IMPORT_CSV));
+  assert(SnailImporter(wideJsonBack)
+             .importBuffer(wideJson.str().data(), wideJson.str().size(), IMPORT_JSONL));
+  std::istringstream wideStream(wideCsv.str());
+  assert(SnailImporter(wideStreamed, nullptr, 64).importStream(wideStream, IMPORT_CSV));
+  SnailDB *wideBacks[] = {&wideCsvBack, &wideJsonBack, &wideStreamed};
+  for (SnailDB *back : wideBacks) {
+    assert(back->getColType(0) == DOUBLE_TYPE && back->getColType(1) == INT64_TYPE);
+    std::ostringstream again;
+    assert(SnailExporter(*back).withTimestamps().writeCsv(again));
+    assert(again.str() == wideCsv.str());
+  }
+
+  // INT -> DOUBLE, and INT -> INT64 -> STR, converting the imported rows
+  std::string mixed = "n,s\n";
+  for (int i = 0; i < 100; ++i) mixed += std::to_string(i) + "," + std::to_string(i) + "\n";
+  mixed += "2.5,3000000000\n1,abc\n";
+  SnailDB mixedBack;
+  SnailImporter mixedIn(mixedBack);
+  assert(mixedIn.importBuffer(mixed.data(), mixed.size(), IMPORT_CSV));
+  assert(mixedIn.getRowsImported() == 102);
+  assert(mixedBack.getColType(0) == DOUBLE_TYPE && mixedBack.getColType(1) == STR_TYPE);
+  assert(mixedBack.findRow("s", "99") == 99 && mixedBack.findRow("s", "3000000000") == 100);
+  mixedBack.tail();
+  assert(mixedBack.get<double>(0) == 1.0 && mixedBack.get<std::string>(1) == "abc");
+
+  // A null past the sample: INT widens to DOUBLE (NaN); BOOL cannot hold it
+  // and the import stops there without retyping the column
+  std::string nulls;
+  for (int i = 0; i < 100; ++i) {
+    nulls += "{\"n\":" + std::to_string(i) + ",\"b\":" + (i % 2 ? "true" : "false") + "}\n";
+  }
+  const std::string nullNum = nulls + "{\"n\":null,\"b\":true}\n";
+  SnailDB nullNumBack;
+  assert(SnailImporter(nullNumBack).importBuffer(nullNum.data(), nullNum.size(), IMPORT_JSONL));
+  assert(nullNumBack.getColType(0) == DOUBLE_TYPE && nullNumBack.getSize() == 101);
+  nullNumBack.tail();
+  assert(std::isnan(nullNumBack.get<double>(0)));
+  const std::string nullBool = nulls + "{\"n\":1,\"b\":null}\n";
+  SnailDB nullBoolBack;
+  SnailImporter nullBoolIn(nullBoolBack);
+  assert(!nullBoolIn.importBuffer(nullBool.data(), nullBool.size(), IMPORT_JSONL));
+  assert(nullBoolIn.getErrorLine() == 101 && nullBoolBack.getSize() == 100);
+  assert(nullBoolBack.getColType(1) == BOOL_TYPE);
+
+  std::cout << "Importer Verified!" << std::endl;
   return 0;
 }
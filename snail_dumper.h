@@ -29,6 +29,14 @@ public:
           os << db.get<int>(c);
         } else if (type == STR_TYPE) {
           os << db.get<std::string>(c);
+        } else if (type == INT64_TYPE) {
+          os << (long long)db.get<int64_t>(c);
+        } else if (type == FLOAT_TYPE) {
+          os << db.get<float>(c);
+        } else if (type == DOUBLE_TYPE) {
+          os << db.get<double>(c);
+        } else if (type == BOOL_TYPE) {
+          os << (db.get<bool>(c) ? "true" : "false");
         } else {
           os << "ERR";
         }
@@ -45,6 +53,79 @@ public:
     for (size_t i = 0; i < originalCursor; ++i)
       db.next();
   }
+
+  // Memory report (used/reserved bytes) and, with SNAILDB_STATS=1, the
+  // hot-path counters and timing histograms
+  static void printStats(const SnailDB &db, std::ostream &os = std::cout) {
+    os << "Memory (used/reserved bytes)\n";
+    os << "column\ttype\tstorage\ttokens\tdict\tindex\n";
+    for (size_t i = 0; i < db.getColCount(); ++i) {
+      SnailMemoryStats m = db.getColMemoryStats(i);
+      os << db.getColName(i) << "\t" << typeName(db.getColType(i)) << "\t";
+      printBytes(os, m.storage);
+      os << "\t";
+      printBytes(os, m.tokens);
+      os << "\t";
+      printBytes(os, m.dictionary);
+      os << "\t";
+      printBytes(os, m.index);
+      os << "\n";
+    }
+
+    SnailMemoryStats total = db.getMemoryStats();
+    os << "tombstones\t";
+    printBytes(os, total.tombstones);
+    os << "\ntimestamps\t";
+    printBytes(os, total.timestamps);
+    os << "\ntotal\t" << total.totalUsed() << "/" << total.totalReserved() << "\n";
+
+    // Runtime check: this header is compiled the same with or without stats
+    if (!SnailStats::enabled()) return;
+    const SnailStats &st = SnailStats::instance();
+    os << "Counters\n";
+    os << "rows inserted\t" << st.rowsInserted << " (" << st.batchInserts << " batches)\n";
+    os << "find binary\t" << st.findBinary << "\n";
+    os << "find index\t" << st.findIndex << "\n";
+    os << "find scan\t" << st.findScan << "\n";
+    os << "find dict miss\t" << st.findDictMiss << "\n";
+    os << "index merges\t" << st.indexMerges << "\n";
+    os << "purges\t" << st.purges << "\nsaves\t" << st.saves << "\nloads\t" << st.loads << "\n";
+    os << "Timings (us)\tcount\tavg\tmax\tbuckets (< bound: count)\n";
+    printHistogram(os, "insert", st.insertTime);
+    printHistogram(os, "purge", st.purgeTime);
+    printHistogram(os, "save", st.saveTime);
+    printHistogram(os, "load", st.loadTime);
+  }
+
+private:
+  static const char *typeName(ColumnType type) {
+    switch (type) {
+    case STR_TYPE: return "STR";
+    case INT_TYPE: return "INT";
+    case INT64_TYPE: return "INT64";
+    case FLOAT_TYPE: return "FLOAT";
+    case DOUBLE_TYPE: return "DOUBLE";
+    case BOOL_TYPE: return "BOOL";
+    }
+    return "ERR";
+  }
+
+  static void printBytes(std::ostream &os, const SnailBytes &b) {
+    os << b.used << "/" << b.reserved;
+  }
+
+  static void printHistogram(std::ostream &os, const char *name, const SnailHistogram &h) {
+    os << name << "\t" << h.count << "\t" << (h.count ? h.totalUs / h.count : 0) << "\t"
+       << h.maxUs << "\t";
+    // Bucket b holds [2^b - 1, 2^(b+1) - 1) us; the last one is open-ended
+    for (int b = 0; b < SnailHistogram::BUCKETS; ++b) {
+      if (!h.buckets[b]) continue;
+      if (b == SnailHistogram::BUCKETS - 1) os << ">=" << ((1u << b) - 1);
+      else os << "<" << ((1u << (b + 1)) - 1);
+      os << ":" << h.buckets[b] << " ";
+    }
+    os << "\n";
+  }
 };
 
 #endif
@@ -0,0 +1,398 @@
+#include "snail_export.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+const size_t SnailExporter::DEFAULT_BUFFER;
+const size_t SnailExporter::ROW_BLOCK;
+
+// =========================================================
+// Text Helpers
+// =========================================================
+
+static const char digitPairs[] = "00010203040506070809"
+                                 "10111213141516171819"
+                                 "20212223242526272829"
+                                 "30313233343536373839"
+                                 "40414243444546474849"
+                                 "50515253545556575859"
+                                 "60616263646566676869"
+                                 "70717273747576777879"
+                                 "80818283848586878889"
+                                 "90919293949596979899";
+
+static std::string csvEscape(const std::string &s) {
+  bool quote = s.find_first_of(",\"\r\n") != std::string::npos;
+  if (!quote) return s;
+  std::string out = "\"";
+  for (char ch : s) {
+    if (ch == '"') out += '"';
+    out += ch;
+  }
+  out += '"';
+  return out;
+}
+
+static std::string jsonEscape(const std::string &s) {
+  std::string out = "\"";
+  for (unsigned char ch : s) {
+    switch (ch) {
+    case '"': out += "\\\""; break;
+    case '\\': out += "\\\\"; break;
+    case '\n': out += "\\n"; break;
+    case '\r': out += "\\r"; break;
+    case '\t': out += "\\t"; break;
+    default:
+      if (ch < 0x20) {
+        char esc[8];
+        std::snprintf(esc, sizeof(esc), "\\u%04x", ch);
+        out += esc;
+      } else {
+        out += (char)ch;
+      }
+    }
+  }
+  out += '"';
+  return out;
+}
+
+// =========================================================
+// SnailExporter
+// =========================================================
+
+SnailExporter::SnailExporter(const SnailDB &db, size_t bufferBytes)
+    : db(db), selection(nullptr), timestamps(false), buffer(bufferBytes ? bufferBytes : 1),
+      used(0), os(nullptr), rowsWritten(0) {}
+
+SnailExporter &SnailExporter::select(const std::string &colName) {
+  projection.push_back(colName);
+  return *this;
+}
+
+SnailExporter &SnailExporter::rows(const std::vector<uint32_t> &sel) {
+  selection = &sel;
+  return *this;
+}
+
+SnailExporter &SnailExporter::withTimestamps(bool on) {
+  timestamps = on;
+  return *this;
+}
+
+bool SnailExporter::resolveColumns() {
+  cols.clear();
+  std::vector<std::string> names = projection;
+  if (names.empty()) names = db.colNames;
+
+  for (const std::string &name : names) {
+    int idx = db.getColIndex(name);
+    if (idx == -1) return false;
+    OutCol c;
+    c.idx = idx;
+    c.col = db.columns[idx].get();
+    c.type = c.col->getType();
+    c.key = jsonEscape(name) + ":";
+    if (c.type == STR_TYPE) {
+      size_t dictSize = static_cast<const InternalStrColumn *>(c.col)->dictionary.size();
+      c.escaped.resize(dictSize);
+      c.ready.assign(dictSize, 0);
+    }
+    cols.push_back(c);
+  }
+  return true;
+}
+
+// Calls fn(rows, n) for blocks of active rows, in row order
+template <typename Fn> void SnailExporter::forEachBlock(Fn fn) const {
+  const std::vector<bool> &active = db.activeRows;
+  uint32_t block[ROW_BLOCK];
+  size_t n = 0;
+
+  if (selection) {
+    for (uint32_t r : *selection) {
+      if (r >= active.size() || !active[r]) continue;
+      block[n++] = r;
+      if (n == ROW_BLOCK) {
+        fn(block, n);
+        n = 0;
+      }
+    }
+    if (n) fn(block, n);
+    return;
+  }
+
+  // One branch-free pass over the tombstones per block
+  for (size_t base = 0; base < db.numRows; base += ROW_BLOCK) {
+    size_t end = base + ROW_BLOCK < db.numRows ? base + ROW_BLOCK : db.numRows;
+    n = 0;
+    for (size_t r = base; r < end; ++r) {
+      block[n] = (uint32_t)r;
+      n += active[r] ? 1 : 0;
+    }
+    if (n) fn(block, n);
+  }
+}
+
+size_t SnailExporter::countRows() const {
+  size_t n = 0;
+  forEachBlock([&n](const uint32_t *, size_t k) { n += k; });
+  return n;
+}
+
+bool SnailExporter::writeCsv(std::ostream &out) {
+  os = &out;
+  used = 0;
+  rowsWritten = 0;
+  if (!resolveColumns()) return false;
+
+  if (timestamps) put("ts", 2);
+  for (size_t c = 0; c < cols.size(); ++c) {
+    if (c > 0 || timestamps) put(',');
+    put(csvEscape(db.colNames[cols[c].idx]));
+  }
+  put('\n');
+
+  writeText(false);
+  flush();
+  return !out.fail();
+}
+
+bool SnailExporter::writeJsonLines(std::ostream &out) {
+  os = &out;
+  used = 0;
+  rowsWritten = 0;
+  if (!resolveColumns()) return false;
+
+  writeText(true);
+  flush();
+  return !out.fail();
+}
+
+void SnailExporter::writeText(bool json) {
+  const std::vector<uint32_t> &ts = db.timestamps;
+  forEachBlock([&](const uint32_t *block, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+      uint32_t row = block[i];
+      if (json) put('{');
+      if (timestamps) {
+        if (json) put("\"ts\":", 5);
+        putInt(ts[row]);
+      }
+      for (size_t c = 0; c < cols.size(); ++c) {
+        if (c > 0 || timestamps) put(',');
+        if (json) put(cols[c].key);
+        writeCell(cols[c], row, json);
+      }
+      if (json) put('}');
+      put('\n');
+    }
+    rowsWritten += n;
+  });
+}
+
+void SnailExporter::writeCell(OutCol &c, uint32_t row, bool json) {
+  switch (c.type) {
+  case INT_TYPE:
+    putInt(static_cast<const InternalIntColumn *>(c.col)->storage[row]);
+    break;
+  case INT64_TYPE:
+    putInt(static_cast<const InternalInt64Column *>(c.col)->storage[row]);
+    break;
+  case FLOAT_TYPE:
+    putDouble(static_cast<const InternalFloatColumn *>(c.col)->storage[row], true, json);
+    break;
+  case DOUBLE_TYPE:
+    putDouble(static_cast<const InternalDoubleColumn *>(c.col)->storage[row], false, json);
+    break;
+  case BOOL_TYPE: {
+    const std::vector<uint8_t> &bits = static_cast<const InternalBoolColumn *>(c.col)->bits;
+    if ((bits[row >> 3] >> (row & 7)) & 1u) put("true", 4);
+    else put("false", 5);
+    break;
+  }
+  case STR_TYPE:
+    put(escapedToken(c, static_cast<const InternalStrColumn *>(c.col)->data[row], json));
+    break;
+  }
+}
+
+const std::string &SnailExporter::escapedToken(OutCol &c, uint16_t token, bool json) {
+  static const std::string empty;
+  if (token >= c.escaped.size()) return empty;
+  if (!c.ready[token]) {
+    const std::string &s = static_cast<const InternalStrColumn *>(c.col)->dictionary[token];
+    c.escaped[token] = json ? jsonEscape(s) : csvEscape(s);
+    c.ready[token] = 1;
+  }
+  return c.escaped[token];
+}
+
+bool SnailExporter::writeBinary(std::ostream &out) {
+  os = &out;
+  used = 0;
+  rowsWritten = 0;
+  if (!resolveColumns()) return false;
+  uint32_t n = (uint32_t)countRows();
+
+  // Header + schema (see SnailStorage::writeHeader / writeSchemaEntry)
+  put("SNAL", 4);
+  putRaw(n);
+  putRaw((uint32_t)cols.size());
+  for (const OutCol &c : cols) {
+    const ColumnInfo &info = db.colInfos[c.idx];
+    putRaw((uint8_t)(info.type | (info.orderedDict ? COL_FLAG_ORDERED_DICT : 0)));
+    putRaw((uint16_t)info.max_length);
+    putRaw((uint8_t)info.name.length());
+    put(info.name.data(), (uint8_t)info.name.length());
+  }
+
+  // Column blocks: the selected rows of each column, back to back
+  for (const OutCol &c : cols) {
+    switch (c.type) {
+    case INT_TYPE: {
+      const std::vector<int> &vals = static_cast<const InternalIntColumn *>(c.col)->storage;
+      forEachBlock([&](const uint32_t *b, size_t k) {
+        for (size_t i = 0; i < k; ++i) putRaw(vals[b[i]]);
+      });
+      break;
+    }
+    case INT64_TYPE: {
+      const std::vector<int64_t> &vals = static_cast<const InternalInt64Column *>(c.col)->storage;
+      forEachBlock([&](const uint32_t *b, size_t k) {
+        for (size_t i = 0; i < k; ++i) putRaw(vals[b[i]]);
+      });
+      break;
+    }
+    case FLOAT_TYPE: {
+      const std::vector<float> &vals = static_cast<const InternalFloatColumn *>(c.col)->storage;
+      forEachBlock([&](const uint32_t *b, size_t k) {
+        for (size_t i = 0; i < k; ++i) putRaw(vals[b[i]]);
+      });
+      break;
+    }
+    case DOUBLE_TYPE: {
+      const std::vector<double> &vals = static_cast<const InternalDoubleColumn *>(c.col)->storage;
+      forEachBlock([&](const uint32_t *b, size_t k) {
+        for (size_t i = 0; i < k; ++i) putRaw(vals[b[i]]);
+      });
+      break;
+    }
+    case BOOL_TYPE: {
+      // Repacked: ceil(n / 8) bytes, LSB first
+      const std::vector<uint8_t> &bits = static_cast<const InternalBoolColumn *>(c.col)->bits;
+      uint8_t byte = 0;
+      unsigned bit = 0;
+      forEachBlock([&](const uint32_t *b, size_t k) {
+        for (size_t i = 0; i < k; ++i) {
+          uint32_t r = b[i];
+          byte |= (uint8_t)(((bits[r >> 3] >> (r & 7)) & 1u) << bit);
+          if (++bit == 8) {
+            put((char)byte);
+            byte = 0;
+            bit = 0;
+          }
+        }
+      });
+      if (bit) put((char)byte);
+      break;
+    }
+    case STR_TYPE: {
+      // The whole dictionary is kept, so tokens are written unchanged
+      const InternalStrColumn *str = static_cast<const InternalStrColumn *>(c.col);
+      putRaw((uint16_t)str->dictionary.size());
+      for (const std::string &s : str->dictionary) {
+        putRaw((uint16_t)s.length());
+        put(s.data(), (uint16_t)s.length());
+      }
+      const std::vector<uint16_t> &data = str->data;
+      forEachBlock([&](const uint32_t *b, size_t k) {
+        for (size_t i = 0; i < k; ++i) putRaw(data[b[i]]);
+      });
+      break;
+    }
+    }
+  }
+
+  // System block: every exported row is active
+  for (uint32_t i = 0; i < n; ++i) put((char)1);
+  const std::vector<uint32_t> &ts = db.timestamps;
+  forEachBlock([&](const uint32_t *b, size_t k) {
+    for (size_t i = 0; i < k; ++i) putRaw(ts[b[i]]);
+  });
+
+  flush();
+  rowsWritten = n;
+  return !out.fail();
+}
+
+// =========================================================
+// Buffered Output
+// =========================================================
+
+void SnailExporter::put(const char *s, size_t n) {
+  if (n > buffer.size() - used) {
+    flush();
+    if (n > buffer.size()) {
+      os->write(s, n);
+      return;
+    }
+  }
+  std::memcpy(&buffer[used], s, n);
+  used += n;
+}
+
+void SnailExporter::flush() {
+  if (used && os) os->write(buffer.data(), used);
+  used = 0;
+}
+
+void SnailExporter::putInt(int64_t v) {
+  char tmp[20];
+  char *p = tmp + sizeof(tmp);
+  uint64_t u = v < 0 ? 0 - (uint64_t)v : (uint64_t)v;
+  // Two digits per division
+  while (u >= 100) {
+    unsigned i = (unsigned)(u % 100) * 2;
+    u /= 100;
+    *--p = digitPairs[i + 1];
+    *--p = digitPairs[i];
+  }
+  if (u >= 10) {
+    unsigned i = (unsigned)u * 2;
+    *--p = digitPairs[i + 1];
+    *--p = digitPairs[i];
+  } else {
+    *--p = (char)('0' + u);
+  }
+  if (v < 0) *--p = '-';
+  put(p, (size_t)(tmp + sizeof(tmp) - p));
+}
+
+void SnailExporter::putDouble(double v, bool isFloat, bool json) {
+  if (!std::isfinite(v)) {
+    if (json) put("null", 4);
+    else if (std::isnan(v)) put("nan", 3);
+    else if (v < 0) put("-inf", 4);
+    else put("inf", 3);
+    return;
+  }
+  // Whole numbers (counters, rounded readings) skip printf. The ".0" keeps
+  // the column a float on re-import, and -0.0 keeps its sign.
+  if (std::fabs(v) < 1e15 && v == (double)(int64_t)v) {
+    if (v == 0 && std::signbit(v)) put("-", 1);
+    putInt((int64_t)v);
+    put(".0", 2);
+    return;
+  }
+  // Shortest precision that reads back to the same value
+  char tmp[32];
+  int len = 0;
+  int maxPrec = isFloat ? 9 : 17;
+  for (int prec = isFloat ? 6 : 15; prec <= maxPrec; ++prec) {
+    len = std::snprintf(tmp, sizeof(tmp), "%.*g", prec, v);
+    double back = std::strtod(tmp, nullptr);
+    if (isFloat ? (float)back == (float)v : back == v) break;
+  }
+  put(tmp, (size_t)len);
+}
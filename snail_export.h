@@ -0,0 +1,89 @@
+// snail_export.h
+#ifndef SNAIL_EXPORT_H
+#define SNAIL_EXPORT_H
+
+#include "snaildb.h"
+#include <ostream>
+
+// =========================================================
+// Streaming Exporters (v1.1)
+// =========================================================
+//
+// Writes a table as CSV, JSON Lines or the binary .snail layout through one
+// reusable buffer:
+//
+//   SnailExporter out(db);
+//   out.select("sensor").select("temp").withTimestamps();
+//   out.writeCsv(file);
+//
+// Integers go through a dedicated integer-to-text routine, floats use the
+// shortest text that reads back to the same value. Each dictionary string
+// is escaped once per export and then copied as-is. Tombstones are skipped
+// a block at a time, and no cursor is moved.
+class SnailExporter {
+public:
+  static const size_t DEFAULT_BUFFER = 64 * 1024;
+
+  explicit SnailExporter(const SnailDB &db, size_t bufferBytes = DEFAULT_BUFFER);
+
+  // Projection; nothing selected exports every column
+  SnailExporter &select(const std::string &colName);
+  // Row selection (e.g. SnailQueryResult::getRowIds()); tombstoned rows are
+  // still skipped. The vector must stay alive until the write returns.
+  SnailExporter &rows(const std::vector<uint32_t> &selection);
+  // CSV / JSON Lines: prepend a "ts" column with the row timestamps
+  SnailExporter &withTimestamps(bool on = true);
+
+  // Return false on an unknown column or a stream error
+  bool writeCsv(std::ostream &os);
+  bool writeJsonLines(std::ostream &os);
+  // Same layout as SnailStorage::save(): SnailStorage::load() reads it back
+  bool writeBinary(std::ostream &os);
+
+  size_t getRowsWritten() const { return rowsWritten; }
+
+private:
+  static const size_t ROW_BLOCK = 1024;
+
+  struct OutCol {
+    int idx;
+    ColumnType type;
+    const Column *col;
+    std::string key;                   // JSON: ,"name":
+    std::vector<std::string> escaped;  // STR: per token, filled on first use
+    std::vector<uint8_t> ready;
+  };
+
+  bool resolveColumns();
+  template <typename Fn> void forEachBlock(Fn fn) const;
+  size_t countRows() const;
+
+  void writeText(bool json);
+  void writeCell(OutCol &c, uint32_t row, bool json);
+  const std::string &escapedToken(OutCol &c, uint16_t token, bool json);
+
+  // Buffered output
+  void put(const char *s, size_t n);
+  void put(const std::string &s) { put(s.data(), s.size()); }
+  void put(char ch) {
+    if (used == buffer.size()) flush();
+    buffer[used++] = ch;
+  }
+  template <typename T> void putRaw(const T &v) { put((const char *)&v, sizeof(T)); }
+  void putInt(int64_t v);
+  void putDouble(double v, bool isFloat, bool json);
+  void flush();
+
+  const SnailDB &db;
+  std::vector<std::string> projection;
+  const std::vector<uint32_t> *selection;
+  bool timestamps;
+
+  std::vector<OutCol> cols;
+  std::vector<char> buffer;
+  size_t used;
+  std::ostream *os;
+  size_t rowsWritten;
+};
+
+#endif // SNAIL_EXPORT_H
@@ -0,0 +1,1020 @@
+#include "snail_import.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+#if !defined(ARDUINO) && (defined(__unix__) || defined(__APPLE__))
+#define SNAIL_IMPORT_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define SNAIL_IMPORT_MMAP 0
+#endif
+
+const size_t SnailImporter::DEFAULT_CHUNK;
+const size_t SnailImporter::SAMPLE_ROWS;
+
+// =========================================================
+// Record Readers
+// =========================================================
+
+enum ImportStatus {
+  IMPORT_OK,    // One record read
+  IMPORT_BLANK, // Empty line (or end of input)
+  IMPORT_MORE,  // Input ends inside the record
+  IMPORT_BAD    // Malformed record
+};
+
+// One field of a record. Plain text points into the input; unescaped text is
+// kept in the record's scratch string ('s' is null).
+struct ImportCell {
+  enum Kind { RAW, TEXT, NUL };
+  Kind kind;
+  const char *s;
+  size_t off;
+  size_t len;
+  size_t keyOff; // JSON Lines: key, always in scratch
+  size_t keyLen;
+
+  const char *text(const std::string &scratch) const { return s ? s : scratch.data() + off; }
+};
+
+// RFC 4180: quoted fields may contain separators, "" and line breaks. A quote
+// inside an unquoted field is rejected, so every quote in valid input opens or
+// closes a quoted field (the chunk splitter relies on that parity).
+static ImportStatus readCsvRecord(const char *&pos, const char *end, bool final,
+                                  std::vector<ImportCell> &cells, std::string &scratch,
+                                  size_t &lines) {
+  const char *p = pos;
+  cells.clear();
+  scratch.clear();
+  lines = 0;
+  if (p == end) return final ? IMPORT_BLANK : IMPORT_MORE;
+  if (*p == '\r' && p + 1 < end) ++p;
+  if (*p == '\n') {
+    pos = p + 1;
+    lines = 1;
+    return IMPORT_BLANK;
+  }
+  p = pos;
+
+  for (;;) {
+    ImportCell cell = { ImportCell::RAW, p, 0, 0, 0, 0 };
+    if (p < end && *p == '"') {
+      cell.kind = ImportCell::TEXT;
+      cell.s = nullptr;
+      cell.off = scratch.size();
+      ++p;
+      for (;;) {
+        const char *q = (const char *)std::memchr(p, '"', (size_t)(end - p));
+        if (!q) return final ? IMPORT_BAD : IMPORT_MORE;
+        scratch.append(p, (size_t)(q - p));
+        lines += (size_t)std::count(p, q, '\n');
+        p = q + 1;
+        if (p == end && !final) return IMPORT_MORE; // Could be half of ""
+        if (p < end && *p == '"') {
+          scratch += '"';
+          ++p;
+          continue;
+        }
+        break;
+      }
+      cell.len = scratch.size() - cell.off;
+      if (p < end && *p == '\r') ++p;
+    } else {
+      const char *q = p;
+      while (q < end && *q != ',' && *q != '\n') {
+        if (*q == '"') return IMPORT_BAD;
+        ++q;
+      }
+      cell.len = (size_t)(q - p);
+      if (cell.len && q[-1] == '\r' && (q == end || *q == '\n')) cell.len--;
+      p = q;
+    }
+    cells.push_back(cell);
+
+    if (p == end) {
+      if (!final) return IMPORT_MORE;
+      pos = p;
+      return IMPORT_OK;
+    }
+    if (*p == ',') {
+      ++p;
+      continue;
+    }
+    if (*p == '\n') {
+      pos = p + 1;
+      lines++;
+      return IMPORT_OK;
+    }
+    return IMPORT_BAD; // Text after a closing quote
+  }
+}
+
+static inline const char *skipSpace(const char *p, const char *end) {
+  while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) ++p;
+  return p;
+}
+
+static bool hex4(const char *p, uint32_t &v) {
+  v = 0;
+  for (int i = 0; i < 4; ++i) {
+    char ch = p[i];
+    v <<= 4;
+    if (ch >= '0' && ch <= '9') v |= (uint32_t)(ch - '0');
+    else if (ch >= 'a' && ch <= 'f') v |= (uint32_t)(ch - 'a' + 10);
+    else if (ch >= 'A' && ch <= 'F') v |= (uint32_t)(ch - 'A' + 10);
+    else return false;
+  }
+  return true;
+}
+
+static void putUtf8(std::string &out, uint32_t cp) {
+  if (cp < 0x80) {
+    out += (char)cp;
+  } else if (cp < 0x800) {
+    out += (char)(0xC0 | (cp >> 6));
+    out += (char)(0x80 | (cp & 0x3F));
+  } else if (cp < 0x10000) {
+    out += (char)(0xE0 | (cp >> 12));
+    out += (char)(0x80 | ((cp >> 6) & 0x3F));
+    out += (char)(0x80 | (cp & 0x3F));
+  } else {
+    out += (char)(0xF0 | (cp >> 18));
+    out += (char)(0x80 | ((cp >> 12) & 0x3F));
+    out += (char)(0x80 | ((cp >> 6) & 0x3F));
+    out += (char)(0x80 | (cp & 0x3F));
+  }
+}
+
+// Unescapes a JSON string (p is past the opening quote) into scratch
+static ImportStatus readJsonString(const char *&p, const char *end, bool final,
+                                   std::string &scratch) {
+  const ImportStatus cut = final ? IMPORT_BAD : IMPORT_MORE;
+  for (;;) {
+    const char *q = p;
+    while (q < end && *q != '"' && *q != '\\' && *q != '\n') ++q;
+    scratch.append(p, (size_t)(q - p));
+    if (q == end) return cut;
+    if (*q == '"') {
+      p = q + 1;
+      return IMPORT_OK;
+    }
+    if (*q == '\n' || q + 1 == end) return *q == '\n' ? IMPORT_BAD : cut;
+
+    p = q + 2;
+    switch (q[1]) {
+    case '"': scratch += '"'; break;
+    case '\\': scratch += '\\'; break;
+    case '/': scratch += '/'; break;
+    case 'b': scratch += '\b'; break;
+    case 'f': scratch += '\f'; break;
+    case 'n': scratch += '\n'; break;
+    case 'r': scratch += '\r'; break;
+    case 't': scratch += '\t'; break;
+    case 'u': {
+      uint32_t cp, lo;
+      if (end - p < 4) return cut;
+      if (!hex4(p, cp)) return IMPORT_BAD;
+      p += 4;
+      if (cp >= 0xD800 && cp < 0xDC00) { // Surrogate pair
+        if (end - p < 6) return cut;
+        if (p[0] != '\\' || p[1] != 'u' || !hex4(p + 2, lo) || lo < 0xDC00 || lo > 0xDFFF) {
+          return IMPORT_BAD;
+        }
+        cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+        p += 6;
+      }
+      putUtf8(scratch, cp);
+      break;
+    }
+    default:
+      return IMPORT_BAD;
+    }
+  }
+}
+
+// Flat objects only: string, number, true/false and null values
+static ImportStatus readJsonRecord(const char *&pos, const char *end, bool final,
+                                   std::vector<ImportCell> &cells, std::string &scratch,
+                                   size_t &lines) {
+  const ImportStatus cut = final ? IMPORT_BAD : IMPORT_MORE;
+  const char *p = skipSpace(pos, end);
+  cells.clear();
+  scratch.clear();
+  lines = 0;
+  if (p == end) {
+    if (!final) return IMPORT_MORE;
+    pos = p;
+    return IMPORT_BLANK;
+  }
+  if (*p == '\n') {
+    pos = p + 1;
+    lines = 1;
+    return IMPORT_BLANK;
+  }
+  if (*p != '{') return IMPORT_BAD;
+
+  p = skipSpace(p + 1, end);
+  if (p < end && *p == '}') {
+    ++p;
+  } else {
+    for (;;) {
+      if (p == end) return cut;
+      if (*p != '"') return IMPORT_BAD;
+      ImportCell cell = { ImportCell::RAW, nullptr, 0, 0, scratch.size(), 0 };
+      ++p;
+      ImportStatus st = readJsonString(p, end, final, scratch);
+      if (st != IMPORT_OK) return st;
+      cell.keyLen = scratch.size() - cell.keyOff;
+
+      p = skipSpace(p, end);
+      if (p == end) return cut;
+      if (*p != ':') return IMPORT_BAD;
+      p = skipSpace(p + 1, end);
+      if (p == end) return cut;
+
+      if (*p == '"') {
+        cell.kind = ImportCell::TEXT;
+        cell.off = scratch.size();
+        ++p;
+        st = readJsonString(p, end, final, scratch);
+        if (st != IMPORT_OK) return st;
+        cell.len = scratch.size() - cell.off;
+      } else {
+        if (*p == '{' || *p == '[') return IMPORT_BAD; // Nested values
+        const char *q = p;
+        while (q < end && *q != ',' && *q != '}' && *q != ' ' && *q != '\t' && *q != '\r' &&
+               *q != '\n') {
+          ++q;
+        }
+        if (q == end) return cut;
+        if (q == p) return IMPORT_BAD;
+        cell.s = p;
+        cell.len = (size_t)(q - p);
+        if (cell.len == 4 && std::memcmp(p, "null", 4) == 0) cell.kind = ImportCell::NUL;
+        p = q;
+      }
+      cells.push_back(cell);
+
+      p = skipSpace(p, end);
+      if (p == end) return cut;
+      if (*p == ',') {
+        p = skipSpace(p + 1, end);
+        continue;
+      }
+      if (*p == '}') {
+        ++p;
+        break;
+      }
+      return IMPORT_BAD;
+    }
+  }
+
+  p = skipSpace(p, end);
+  if (p == end) {
+    if (!final) return IMPORT_MORE;
+  } else if (*p == '\n') {
+    ++p;
+    lines = 1;
+  } else {
+    return IMPORT_BAD; // One object per line
+  }
+  pos = p;
+  return IMPORT_OK;
+}
+
+static inline ImportStatus readRecord(SnailImportFormat fmt, const char *&pos, const char *end,
+                                      bool final, std::vector<ImportCell> &cells,
+                                      std::string &scratch, size_t &lines) {
+  return fmt == IMPORT_CSV ? readCsvRecord(pos, end, final, cells, scratch, lines)
+                           : readJsonRecord(pos, end, final, cells, scratch, lines);
+}
+
+// =========================================================
+// Value Conversion
+// =========================================================
+
+static bool parseInt64(const char *s, size_t len, int64_t &out) {
+  size_t i = 0;
+  bool neg = false;
+  if (i < len && (s[i] == '-' || s[i] == '+')) neg = s[i++] == '-';
+  if (i == len || len - i > 19) return false;
+
+  uint64_t v = 0;
+  for (; i < len; ++i) {
+    unsigned d = (unsigned)((unsigned char)s[i] - '0');
+    if (d > 9) return false;
+    v = v * 10 + d;
+  }
+  const uint64_t limit = (uint64_t)std::numeric_limits<int64_t>::max();
+  if (v > limit + (neg ? 1 : 0)) return false;
+  out = neg ? -(int64_t)(v - 1) - 1 : (int64_t)v;
+  return true;
+}
+
+static bool parseDouble(const char *s, size_t len, double &out) {
+  char tmp[64]; // Fields are not NUL-terminated (and may end the mapping)
+  if (len == 0 || len >= sizeof(tmp)) return false;
+  std::memcpy(tmp, s, len);
+  tmp[len] = '\0';
+  char *stop;
+  out = std::strtod(tmp, &stop);
+  return stop == tmp + len;
+}
+
+static bool parseBool(const char *s, size_t len, int64_t &out) {
+  if ((len == 4 && std::memcmp(s, "true", 4) == 0) || (len == 1 && *s == '1')) {
+    out = 1;
+  } else if ((len == 5 && std::memcmp(s, "false", 5) == 0) || (len == 1 && *s == '0')) {
+    out = 0;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+struct ImportValue {
+  int64_t i;     // INT, INT64, BOOL, timestamps
+  double d;      // FLOAT, DOUBLE
+  const char *s; // STR
+  size_t len;
+};
+
+static bool convertCell(const ImportCell &cell, const std::string &scratch, ColumnType type,
+                        ImportValue &v) {
+  if (cell.kind == ImportCell::NUL) {
+    // SnailExporter writes non-finite floats as null
+    if (type != FLOAT_TYPE && type != DOUBLE_TYPE) return false;
+    v.d = std::numeric_limits<double>::quiet_NaN();
+    return true;
+  }
+  const char *s = cell.text(scratch);
+  switch (type) {
+  case STR_TYPE:
+    v.s = s;
+    v.len = cell.len;
+    return true;
+  case INT_TYPE:
+    return parseInt64(s, cell.len, v.i) && v.i >= std::numeric_limits<int>::min() &&
+           v.i <= std::numeric_limits<int>::max();
+  case INT64_TYPE:
+    return parseInt64(s, cell.len, v.i);
+  case FLOAT_TYPE:
+  case DOUBLE_TYPE:
+    return parseDouble(s, cell.len, v.d);
+  case BOOL_TYPE:
+    return parseBool(s, cell.len, v.i);
+  }
+  return false;
+}
+
+// Narrowest type that holds every sampled value of a field
+struct ImportGuess {
+  bool seen;
+  bool isBool;
+  bool isInt;
+  bool isInt64;
+  bool isDouble;
+  size_t maxLen;
+
+  void add(const ImportCell &cell, const std::string &scratch) {
+    seen = true;
+    if (cell.len > maxLen) maxLen = cell.len;
+    if (cell.kind == ImportCell::TEXT) {
+      isBool = isInt = isInt64 = isDouble = false;
+      return;
+    }
+    if (cell.kind == ImportCell::NUL) {
+      isBool = isInt = isInt64 = false;
+      return;
+    }
+    const char *s = cell.text(scratch);
+    ImportValue v;
+    isBool = isBool && ((cell.len == 4 && std::memcmp(s, "true", 4) == 0) ||
+                        (cell.len == 5 && std::memcmp(s, "false", 5) == 0));
+    isInt64 = isInt64 && convertCell(cell, scratch, INT64_TYPE, v);
+    isInt = isInt && isInt64 && convertCell(cell, scratch, INT_TYPE, v);
+    isDouble = isDouble && convertCell(cell, scratch, DOUBLE_TYPE, v);
+  }
+
+  ColumnType type() const {
+    if (!seen) return STR_TYPE;
+    if (isBool) return BOOL_TYPE;
+    if (isInt) return INT_TYPE;
+    if (isInt64) return INT64_TYPE;
+    if (isDouble) return DOUBLE_TYPE;
+    return STR_TYPE;
+  }
+
+  // Narrowest type that holds the values of 'from' and this cell
+  static ColumnType widen(ColumnType from, const ImportCell &cell, const std::string &scratch) {
+    bool num = from == INT_TYPE || from == INT64_TYPE || from == FLOAT_TYPE ||
+               from == DOUBLE_TYPE;
+    ImportGuess g = { true, from == BOOL_TYPE, from == INT_TYPE,
+                      from == INT_TYPE || from == INT64_TYPE, num, 0 };
+    g.add(cell, scratch);
+    return g.type();
+  }
+};
+
+// Shortest text that reads back to the same value (see SnailExporter)
+static std::string formatDouble(double v) {
+  char tmp[32];
+  for (int prec = 15; prec <= 17; ++prec) {
+    std::snprintf(tmp, sizeof(tmp), "%.*g", prec, v);
+    if (std::strtod(tmp, nullptr) == v) break;
+  }
+  return tmp;
+}
+
+// =========================================================
+// Chunk Buffers
+// =========================================================
+
+static uint32_t hashBytes(const char *s, size_t len) {
+  uint32_t h = 2166136261u; // FNV-1a
+  for (size_t i = 0; i < len; ++i) {
+    h ^= (uint8_t)s[i];
+    h *= 16777619u;
+  }
+  return h;
+}
+
+// Parsed values of one column within a chunk. STR values are tokens into a
+// chunk-local dictionary, resolved against the column when appended.
+struct ImportColumn {
+  static const uint16_t OVERFLOW_TOKEN = 0xFFFF; // Not a local entry
+
+  ColumnType type;
+  std::vector<int> ints;
+  std::vector<int64_t> int64s;
+  std::vector<float> floats;
+  std::vector<double> doubles;
+  std::vector<uint8_t> bools;
+  std::vector<uint16_t> tokens;
+  std::vector<std::string> dict;
+  std::vector<uint32_t> hashes; // Per dictionary entry
+  std::vector<uint32_t> slots;  // Open addressing: token + 1, 0 = empty
+
+  void push(const ImportValue &v) {
+    switch (type) {
+    case INT_TYPE: ints.push_back((int)v.i); break;
+    case INT64_TYPE: int64s.push_back(v.i); break;
+    case FLOAT_TYPE: floats.push_back((float)v.d); break;
+    case DOUBLE_TYPE: doubles.push_back(v.d); break;
+    case BOOL_TYPE: bools.push_back(v.i ? 1 : 0); break;
+    case STR_TYPE: tokens.push_back(intern(v.s, v.len)); break;
+    }
+  }
+
+  uint16_t intern(const char *s, size_t len) {
+    if (slots.empty()) slots.assign(64, 0);
+    uint32_t h = hashBytes(s, len);
+    size_t mask = slots.size() - 1;
+    for (size_t i = h & mask;; i = (i + 1) & mask) {
+      uint32_t slot = slots[i];
+      if (slot == 0) {
+        if (dict.size() >= 65535) return OVERFLOW_TOKEN;
+        dict.push_back(std::string(s, len));
+        hashes.push_back(h);
+        slots[i] = (uint32_t)dict.size();
+        if (dict.size() * 2 > slots.size()) grow();
+        return (uint16_t)(dict.size() - 1);
+      }
+      const std::string &d = dict[slot - 1];
+      if (hashes[slot - 1] == h && d.size() == len && std::memcmp(d.data(), s, len) == 0) {
+        return (uint16_t)(slot - 1);
+      }
+    }
+  }
+
+  void grow() {
+    slots.assign(slots.size() * 2, 0);
+    size_t mask = slots.size() - 1;
+    for (size_t t = 0; t < dict.size(); ++t) {
+      size_t i = hashes[t] & mask;
+      while (slots[i]) i = (i + 1) & mask;
+      slots[i] = (uint32_t)(t + 1);
+    }
+  }
+};
+
+const uint16_t ImportColumn::OVERFLOW_TOKEN;
+
+struct SnailImporter::Chunk {
+  const char *begin;
+  const char *end;
+  bool final; // No record continues past 'end'
+  std::vector<ImportColumn> cols;
+  std::vector<uint32_t> ts;
+  size_t rows;
+  size_t lines;    // Lines consumed (before the bad record, if failed)
+  size_t consumed; // Bytes consumed
+  bool failed;
+  int widenCol; // Column whose type the record at 'consumed' does not fit
+  ColumnType widenType;
+};
+
+// =========================================================
+// SnailImporter
+// =========================================================
+
+SnailImporter::SnailImporter(SnailDB &db, SnailThreadPool *pool, size_t chunkBytes)
+    : db(db), pool(pool), chunkBytes(chunkBytes ? chunkBytes : 1), format(IMPORT_CSV),
+      inferred(false), hasTs(false), orderedDicts(false), lineNo(0), rowsImported(0), errorLine(0), failed(false) {}
+
+template <typename Fn> void SnailImporter::forEach(size_t count, Fn fn) const {
+  if (pool && count > 1) {
+    pool->parallelFor(count, [&](size_t, size_t task) { fn(task); });
+  } else {
+    for (size_t i = 0; i < count; ++i) fn(i);
+  }
+}
+
+void SnailImporter::start(SnailImportFormat fmt) {
+  format = fmt;
+  fieldNames.clear();
+  fieldTargets.clear();
+  colTypes.clear();
+  inferred = false;
+  hasTs = false;
+  lineNo = 0;
+  rowsImported = 0;
+  errorLine = 0;
+  failed = false;
+}
+
+bool SnailImporter::importFile(const std::string &path, SnailImportFormat fmt) {
+#if SNAIL_IMPORT_MMAP
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) return false;
+  struct stat st;
+  if (::fstat(fd, &st) != 0) {
+    ::close(fd);
+    return false;
+  }
+  size_t len = (size_t)st.st_size;
+  if (len == 0) {
+    ::close(fd);
+    return importBuffer("", 0, fmt);
+  }
+  void *map = ::mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (map != MAP_FAILED) {
+    ::posix_madvise(map, len, POSIX_MADV_SEQUENTIAL);
+    bool ok = importBuffer(static_cast<const char *>(map), len, fmt);
+    ::munmap(map, len);
+    return ok;
+  }
+  // Not mappable (e.g. a pipe): stream it instead
+#endif
+  std::ifstream in(path, std::ios::binary);
+  if (!in.is_open()) return false;
+  return importStream(in, fmt);
+}
+
+bool SnailImporter::importBuffer(const char *data, size_t len, SnailImportFormat fmt) {
+  start(fmt);
+  size_t pos = 0;
+  if (begin(data, len, true, pos) != STEP_DONE) return false;
+  while (pos < len && !failed) {
+    size_t used = consume(data + pos, len - pos, true);
+    if (used == 0) break;
+    pos += used;
+  }
+  return !failed;
+}
+
+bool SnailImporter::importStream(std::istream &is, SnailImportFormat fmt) {
+  start(fmt);
+  // Records may straddle reads: the unparsed tail moves to the front
+  const size_t window = chunkBytes * maxChunks();
+  std::vector<char> buf;
+  size_t have = 0;
+  bool started = false;
+
+  for (;;) {
+    if (buf.size() < have + window) buf.resize(have + window);
+    is.read(buf.data() + have, (std::streamsize)window);
+    have += (size_t)is.gcount();
+    if (is.bad()) return false;
+    bool eof = !is;
+
+    size_t pos = 0;
+    if (!started) {
+      Step step = begin(buf.data(), have, eof, pos);
+      if (step == STEP_FAIL) return false;
+      if (step == STEP_MORE) continue;
+      started = true;
+    }
+    while (pos < have) {
+      size_t used = consume(buf.data() + pos, have - pos, eof);
+      if (failed) return false;
+      if (used == 0) break;
+      pos += used;
+    }
+    if (eof) return true;
+    std::memmove(buf.data(), buf.data() + pos, have - pos);
+    have -= pos;
+  }
+}
+
+// Reads the field names, then binds them to the table (or creates it).
+// CSV consumes the header; JSON Lines keeps the first object as data.
+SnailImporter::Step SnailImporter::begin(const char *data, size_t len, bool final,
+                                         size_t &consumed) {
+  consumed = 0;
+  const char *end = data + len;
+  const char *p = data;
+  const char *first = data;
+  std::vector<ImportCell> cells;
+  std::string scratch;
+  size_t lines = 0, blank = 0;
+
+  ImportStatus st;
+  for (;;) {
+    first = p;
+    st = readRecord(format, p, end, final, cells, scratch, lines);
+    if (st != IMPORT_BLANK || (p == end && final)) break;
+    blank += lines;
+  }
+  if (st == IMPORT_MORE) return STEP_MORE;
+  if (st == IMPORT_BAD) {
+    errorLine = lineNo + blank + 1;
+    return STEP_FAIL;
+  }
+  if (st == IMPORT_BLANK) { // Nothing but blank lines
+    consumed = len;
+    return STEP_DONE;
+  }
+
+  std::vector<std::string> names;
+  for (const ImportCell &cell : cells) {
+    std::string name = format == IMPORT_CSV ? std::string(cell.text(scratch), cell.len)
+                                            : scratch.substr(cell.keyOff, cell.keyLen);
+    if (std::find(names.begin(), names.end(), name) != names.end()) {
+      errorLine = lineNo + blank + 1;
+      return STEP_FAIL;
+    }
+    names.push_back(name);
+  }
+
+  const char *sample = format == IMPORT_CSV ? p : first;
+  if (db.columns.empty() && !final) {
+    // Type inference needs at least one complete row
+    const char *q = sample;
+    size_t n;
+    ImportStatus row;
+    do {
+      row = readRecord(format, q, end, final, cells, scratch, n);
+    } while (row == IMPORT_BLANK && q < end);
+    if (row == IMPORT_MORE) return STEP_MORE;
+  }
+
+  if (!bindSchema(names, sample, end, final)) {
+    errorLine = lineNo + blank + 1;
+    return STEP_FAIL;
+  }
+  consumed = (size_t)(sample - data);
+  lineNo += format == IMPORT_CSV ? blank + lines : blank;
+  return STEP_DONE;
+}
+
+bool SnailImporter::bindSchema(const std::vector<std::string> &names, const char *sample,
+                               const char *end, bool final) {
+  fieldNames = names;
+  fieldTargets.assign(names.size(), 0);
+  hasTs = false;
+
+  inferred = db.columns.empty();
+  if (inferred) {
+    // Infer the types from the first rows
+    std::vector<ImportGuess> guesses(names.size());
+    for (ImportGuess &g : guesses) g = { false, true, true, true, true, 0 };
+    std::vector<ImportCell> cells;
+    std::string scratch;
+    size_t rows = 0, lines;
+    while (rows < SAMPLE_ROWS && sample < end) {
+      ImportStatus st = readRecord(format, sample, end, final, cells, scratch, lines);
+      if (st == IMPORT_BLANK) continue;
+      if (st != IMPORT_OK) break; // Reported by the parse
+      for (size_t i = 0; i < cells.size(); ++i) {
+        int f = format == IMPORT_CSV ? (i < names.size() ? (int)i : -1)
+                                     : fieldIndex(scratch.data() + cells[i].keyOff,
+                                                  cells[i].keyLen, i);
+        if (f >= 0) guesses[f].add(cells[i], scratch);
+      }
+      rows++;
+    }
+
+    for (size_t f = 0; f < names.size(); ++f) {
+      if (names[f] == "ts" && !hasTs) {
+        fieldTargets[f] = FIELD_TS;
+        hasTs = true;
+        continue;
+      }
+      ColumnType type = guesses[f].type();
+      db.addColProp(names[f], type == STR_TYPE ? guesses[f].maxLen : 0, type,
+                    orderedDicts);
+      fieldTargets[f] = (int)db.columns.size() - 1;
+    }
+  } else {
+    std::vector<bool> covered(db.columns.size(), false);
+    for (size_t f = 0; f < names.size(); ++f) {
+      int idx = db.getColIndex(names[f]);
+      if (idx == -1 && names[f] == "ts" && !hasTs) {
+        fieldTargets[f] = FIELD_TS;
+        hasTs = true;
+        continue;
+      }
+      if (idx == -1 || covered[idx]) return false;
+      covered[idx] = true;
+      fieldTargets[f] = idx;
+    }
+    if (std::find(covered.begin(), covered.end(), false) != covered.end()) return false;
+  }
+
+  colTypes.resize(db.columns.size());
+  for (size_t i = 0; i < db.columns.size(); ++i) colTypes[i] = db.columns[i]->getType();
+  return true;
+}
+
+int SnailImporter::fieldIndex(const char *key, size_t len, size_t hint) const {
+  // Objects usually repeat the key order of the first line
+  if (hint < fieldNames.size() && fieldNames[hint].size() == len &&
+      std::memcmp(fieldNames[hint].data(), key, len) == 0) {
+    return (int)hint;
+  }
+  for (size_t f = 0; f < fieldNames.size(); ++f) {
+    if (fieldNames[f].size() == len && std::memcmp(fieldNames[f].data(), key, len) == 0) {
+      return (int)f;
+    }
+  }
+  return -1;
+}
+
+// Parses at most maxChunks() chunks of complete records, appends them and
+// returns the bytes used. A record cut off by the end of the input is left
+// for the next call unless 'final'.
+size_t SnailImporter::consume(const char *data, size_t len, bool final) {
+  size_t span = chunkBytes * maxChunks();
+  for (;;) {
+    size_t window = std::min(len, span);
+    bool windowFinal = final && window == len;
+    size_t n = (window + chunkBytes - 1) / chunkBytes;
+
+    // Chunk k starts at the first record boundary after k * chunkBytes. For
+    // CSV a newline is a boundary only outside quotes, so the quote parity
+    // at each raw offset comes from per-range quote counts.
+    std::vector<size_t> quotes(n, 0);
+    if (format == IMPORT_CSV) {
+      forEach(n, [&](size_t k) {
+        const char *b = data + k * chunkBytes;
+        const char *e = data + std::min(window, (k + 1) * chunkBytes);
+        quotes[k] = (size_t)std::count(b, e, '"');
+      });
+    }
+    std::vector<size_t> bounds(n + 1, window);
+    bounds[0] = 0;
+    size_t parity = 0;
+    for (size_t k = 1; k < n; ++k) {
+      parity ^= quotes[k - 1] & 1;
+      const char *q = data + k * chunkBytes;
+      const char *e = data + window;
+      if (format == IMPORT_CSV) {
+        size_t inQuotes = parity;
+        while (q < e) {
+          char ch = *q++;
+          if (ch == '"') inQuotes ^= 1;
+          else if (ch == '\n' && !inQuotes) break;
+        }
+      } else {
+        // JSON strings cannot hold a raw newline
+        const char *nl = (const char *)std::memchr(q, '\n', (size_t)(e - q));
+        q = nl ? nl + 1 : e;
+      }
+      bounds[k] = std::max((size_t)(q - data), bounds[k - 1]);
+    }
+
+    std::vector<Chunk> chunks(n);
+    for (size_t k = 0; k < n; ++k) {
+      Chunk &c = chunks[k];
+      c.begin = data + bounds[k];
+      c.end = data + bounds[k + 1];
+      c.final = bounds[k + 1] < window || windowFinal;
+      c.rows = c.lines = c.consumed = 0;
+      c.failed = false;
+      c.widenCol = -1;
+    }
+    forEach(n, [&](size_t k) { parseChunk(chunks[k]); });
+
+    size_t consumed = 0;
+    bool widened = false;
+    for (size_t k = 0; k < n; ++k) {
+      const Chunk &c = chunks[k];
+      append(c);
+      consumed = bounds[k] + c.consumed;
+      if (c.failed) {
+        failed = true;
+        errorLine = lineNo + c.lines + 1;
+        return consumed;
+      }
+      lineNo += c.lines;
+      if (c.widenCol >= 0) {
+        // Later chunks were parsed with the old type: parse again from here
+        widenColumn((size_t)c.widenCol, c.widenType);
+        widened = true;
+        break;
+      }
+      if (c.begin + c.consumed < c.end) break; // Tail continues in the next call
+    }
+    if (widened && consumed == 0) continue;
+    // A record longer than the window: retry with a larger one
+    if (consumed > 0 || window == len) return consumed;
+    span *= 2;
+  }
+}
+
+void SnailImporter::parseChunk(Chunk &c) const {
+  size_t nFields = fieldNames.size();
+  c.cols.resize(colTypes.size());
+  for (size_t i = 0; i < colTypes.size(); ++i) c.cols[i].type = colTypes[i];
+
+  std::vector<ImportCell> cells;
+  std::vector<ImportValue> values(nFields);
+  std::vector<uint8_t> seen(nFields);
+  std::string scratch;
+  const char *p = c.begin;
+
+  while (p < c.end) {
+    const char *rec = p;
+    size_t lines = 0;
+    ImportStatus st = readRecord(format, p, c.end, c.final, cells, scratch, lines);
+    if (st == IMPORT_MORE) {
+      p = rec;
+      break;
+    }
+    if (st == IMPORT_BLANK) {
+      c.lines += lines;
+      continue;
+    }
+
+    // Convert the whole record before storing any of it
+    bool ok = st == IMPORT_OK && cells.size() == nFields;
+    std::fill(seen.begin(), seen.end(), 0);
+    for (size_t i = 0; ok && i < cells.size(); ++i) {
+      const ImportCell &cell = cells[i];
+      int f = format == IMPORT_CSV ? (int)i
+                                   : fieldIndex(scratch.data() + cell.keyOff, cell.keyLen, i);
+      if (f < 0 || seen[f]) {
+        ok = false;
+        break;
+      }
+      seen[f] = 1;
+      int target = fieldTargets[f];
+      if (target == FIELD_TS) {
+        ok = convertCell(cell, scratch, INT64_TYPE, values[f]) && values[f].i >= 0 &&
+             values[f].i <= (int64_t)std::numeric_limits<uint32_t>::max();
+      } else {
+        ok = convertCell(cell, scratch, colTypes[target], values[f]);
+        if (!ok && inferred) {
+          // Only widen to a type that takes this cell (a null fits no STR)
+          ColumnType wider = ImportGuess::widen(colTypes[target], cell, scratch);
+          if (wider != colTypes[target] && convertCell(cell, scratch, wider, values[f])) {
+            c.widenCol = target;
+            c.widenType = wider;
+            break;
+          }
+        }
+      }
+    }
+    if (c.widenCol >= 0) {
+      p = rec;
+      break;
+    }
+    if (!ok) {
+      p = rec;
+      c.failed = true;
+      break;
+    }
+
+    for (size_t f = 0; f < nFields; ++f) {
+      int target = fieldTargets[f];
+      if (target == FIELD_TS) c.ts.push_back((uint32_t)values[f].i);
+      else c.cols[target].push(values[f]);
+    }
+    c.rows++;
+    c.lines += lines;
+  }
+  c.consumed = (size_t)(p - c.begin);
+}
+
+// One bulk append per column, like SnailDB::insertBatch()
+void SnailImporter::append(const Chunk &c) {
+  size_t n = c.rows;
+  if (n == 0) return;
+  SNAIL_TIMED(insertTime);
+  SNAIL_COUNT(batchInserts, 1);
+  SNAIL_COUNT(rowsInserted, (uint32_t)n);
+
+  for (size_t i = 0; i < db.columns.size(); ++i) {
+    Column *col = db.columns[i].get();
+    const ImportColumn &src = c.cols[i];
+    switch (src.type) {
+    case INT_TYPE:
+      col->addInts(src.ints.data(), n);
+      break;
+    case INT64_TYPE:
+      col->addInt64s(src.int64s.data(), n);
+      break;
+    case FLOAT_TYPE:
+      col->addFloats(src.floats.data(), n);
+      break;
+    case DOUBLE_TYPE:
+      col->addDoubles(src.doubles.data(), n);
+      break;
+    case BOOL_TYPE: {
+      std::unique_ptr<bool[]> tmp(new bool[n]);
+      for (size_t r = 0; r < n; ++r) tmp[r] = src.bools[r] != 0;
+      col->addBools(tmp.get(), n);
+      break;
+    }
+    case STR_TYPE:
+      static_cast<InternalStrColumn *>(col)->addTokens(src.dict, src.tokens.data(), n);
+      break;
+    }
+  }
+
+  // System fields
+  db.activeRows.insert(db.activeRows.end(), n, true);
+  size_t tsStart = db.timestamps.size();
+  if (hasTs) {
+    db.timestamps.insert(db.timestamps.end(), c.ts.begin(), c.ts.end());
+  } else {
+    db.timestamps.insert(db.timestamps.end(), n, 0);
+  }
+  if (db.tsSorted) {
+    size_t from = tsStart ? tsStart - 1 : 0; // Include the seam
+    db.tsSorted = std::is_sorted(db.timestamps.begin() + from, db.timestamps.end());
+  }
+  db.numRows += n;
+  rowsImported += n;
+}
+
+// Replaces an inferred column with a wider one holding the same rows
+void SnailImporter::widenColumn(size_t idx, ColumnType type) {
+  const Column *old = db.columns[idx].get();
+  ColumnType from = old->getType();
+  size_t n = old->size();
+  ColumnInfo &info = db.colInfos[idx];
+  std::unique_ptr<Column> col;
+
+  switch (type) {
+  case INT64_TYPE: {
+    std::vector<int64_t> vals(n);
+    for (size_t r = 0; r < n; ++r) vals[r] = old->getInt(r);
+    col.reset(new InternalInt64Column());
+    col->addInt64s(vals.data(), n);
+    break;
+  }
+  case DOUBLE_TYPE: {
+    std::vector<double> vals(n);
+    for (size_t r = 0; r < n; ++r) {
+      vals[r] = from == INT_TYPE ? (double)old->getInt(r) : (double)old->getInt64(r);
+    }
+    col.reset(new InternalDoubleColumn());
+    col->addDoubles(vals.data(), n);
+    break;
+  }
+  case STR_TYPE: {
+    std::vector<std::string> vals(n);
+    for (size_t r = 0; r < n; ++r) {
+      switch (from) {
+      case INT_TYPE: vals[r] = std::to_string(old->getInt(r)); break;
+      case INT64_TYPE: vals[r] = std::to_string(old->getInt64(r)); break;
+      case FLOAT_TYPE:
+      case DOUBLE_TYPE: vals[r] = formatDouble(old->getDouble(r)); break;
+      case BOOL_TYPE: vals[r] = old->getBool(r) ? "true" : "false"; break;
+      case STR_TYPE: break;
+      }
+      if (vals[r].size() > info.max_length) info.max_length = vals[r].size();
+    }
+    col.reset(new InternalStrColumn(info.max_length, orderedDicts));
+    col->addStrs(vals.data(), n);
+    info.orderedDict = orderedDicts;
+    break;
+  }
+  default:
+    return; // Never narrower than INT64
+  }
+
+  db.columns[idx] = std::move(col);
+  info.type = type;
+  colTypes[idx] = type;
+  db.schemaEpoch++;
+}
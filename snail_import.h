@@ -0,0 +1,98 @@
+// snail_import.h
+#ifndef SNAIL_IMPORT_H
+#define SNAIL_IMPORT_H
+
+#include "snail_parallel.h"
+#include <istream>
+
+enum SnailImportFormat {
+  IMPORT_CSV,  // Header line with the field names, then one record per row
+  IMPORT_JSONL // One flat object per line
+};
+
+// =========================================================
+// Bulk Importer (v1.1)
+// =========================================================
+//
+// Reads CSV or JSON Lines (e.g. SnailExporter output) into a table:
+//
+//   SnailThreadPool pool;
+//   SnailImporter in(db, &pool);
+//   in.importFile("archive.csv", IMPORT_CSV);
+//
+// A table without columns takes its schema from the input: the CSV header or
+// the keys of the first object, with types inferred from the first rows
+// (INT, INT64, DOUBLE, BOOL, otherwise STR). A later value that does not fit
+// widens its column (INT -> INT64 -> DOUBLE -> STR) and the rows already
+// imported are converted; a value no wider type holds (a null in a BOOL or
+// STR column) is an error. A table with columns is matched by name, and
+// every column must be present. A "ts" field that is not a
+// column fills the timestamps, as written by SnailExporter::withTimestamps().
+//
+// The input is cut into line-aligned chunks that are parsed in parallel, each
+// into typed column vectors with its own string dictionary. Chunks are then
+// appended in order with one bulk append per column: a chunk dictionary is
+// merged into the column's once per distinct string, and its tokens are
+// remapped. Files are memory-mapped on Linux / POSIX hosts; elsewhere, and
+// for streams, the input is read a window at a time.
+class SnailImporter {
+public:
+#ifdef ARDUINO
+  static const size_t DEFAULT_CHUNK = 4 * 1024;
+#else
+  static const size_t DEFAULT_CHUNK = 1024 * 1024;
+#endif
+
+  // Without a pool (or on Arduino) chunks are parsed on the caller
+  explicit SnailImporter(SnailDB &db, SnailThreadPool *pool = nullptr,
+                         size_t chunkBytes = DEFAULT_CHUNK);
+
+  // Return false on an I/O error, a schema mismatch or a malformed record.
+  // Rows before the first bad record are kept.
+  bool importFile(const std::string &path, SnailImportFormat fmt);
+  bool importStream(std::istream &is, SnailImportFormat fmt);
+  bool importBuffer(const char *data, size_t len, SnailImportFormat fmt);
+
+  // Inferred STR columns get an ordered dictionary (see addStrColProp)
+  void setOrderedDictionaries(bool on) { orderedDicts = on; }
+
+  size_t getRowsImported() const { return rowsImported; } // Last import
+  size_t getErrorLine() const { return errorLine; }       // 1-based, 0 = none
+
+private:
+  static const int FIELD_TS = -1; // Field fills the timestamps
+  static const size_t SAMPLE_ROWS = 64;
+
+  enum Step { STEP_FAIL, STEP_MORE, STEP_DONE };
+  struct Chunk;
+
+  void start(SnailImportFormat fmt);
+  Step begin(const char *data, size_t len, bool final, size_t &consumed);
+  bool bindSchema(const std::vector<std::string> &names, const char *sample,
+                  const char *end, bool final);
+  size_t consume(const char *data, size_t len, bool final);
+  void parseChunk(Chunk &c) const;
+  void append(const Chunk &c);
+  void widenColumn(size_t idx, ColumnType type);
+  int fieldIndex(const char *key, size_t len, size_t hint) const;
+  size_t maxChunks() const { return pool ? pool->getThreadCount() * 4 : 1; }
+  template <typename Fn> void forEach(size_t count, Fn fn) const;
+
+  SnailDB &db;
+  SnailThreadPool *pool;
+  size_t chunkBytes;
+
+  SnailImportFormat format;
+  std::vector<std::string> fieldNames; // Input order
+  std::vector<int> fieldTargets;       // Column index or FIELD_TS
+  std::vector<ColumnType> colTypes;
+  bool inferred; // Columns created by this import: widened on a misfit
+  bool hasTs;
+  bool orderedDicts;
+  size_t lineNo; // Lines consumed so far
+  size_t rowsImported;
+  size_t errorLine;
+  bool failed;
+};
+
+#endif // SNAIL_IMPORT_H
@@ -0,0 +1,322 @@
+#include "snail_parallel.h"
+#include <limits>
+
+// =========================================================
+// SnailThreadPool
+// =========================================================
+
+#if SNAILDB_THREADS
+
+SnailThreadPool::SnailThreadPool(size_t threadCount)
+    : job(nullptr), pending(0), generation(0), stopping(false) {
+  if (threadCount == 0) threadCount = std::thread::hardware_concurrency();
+  if (threadCount == 0) threadCount = 1;
+
+  for (size_t i = 0; i < threadCount; ++i) {
+    queues.push_back(std::unique_ptr<Queue>(new Queue()));
+  }
+  // Worker 0 is the thread calling parallelFor
+  for (size_t i = 1; i < threadCount; ++i) {
+    threads.push_back(std::thread(&SnailThreadPool::workerLoop, this, i));
+  }
+}
+
+SnailThreadPool::~SnailThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    stopping = true;
+  }
+  wake.notify_all();
+  for (auto &t : threads) t.join();
+}
+
+size_t SnailThreadPool::getThreadCount() const { return queues.size(); }
+
+void SnailThreadPool::parallelFor(size_t count, const Body &body) {
+  if (count == 0) return;
+  if (queues.size() == 1 || count == 1) {
+    for (size_t i = 0; i < count; ++i) body(0, i);
+    return;
+  }
+
+  std::lock_guard<std::mutex> run(runMutex);
+  job.store(&body);
+  pending.store(count);
+
+  // Contiguous blocks keep neighbouring morsels on the same core; stealing
+  // evens out the tail
+  size_t n = queues.size();
+  for (size_t w = 0; w < n; ++w) {
+    std::lock_guard<std::mutex> lock(queues[w]->m);
+    for (size_t t = w * count / n; t < (w + 1) * count / n; ++t) {
+      queues[w]->tasks.push_back(t);
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    generation++;
+  }
+  wake.notify_all();
+
+  work(0);
+
+  std::unique_lock<std::mutex> lock(stateMutex);
+  done.wait(lock, [this] { return pending.load() == 0; });
+  job.store(nullptr);
+}
+
+void SnailThreadPool::workerLoop(size_t id) {
+  uint64_t seen = 0;
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(stateMutex);
+      wake.wait(lock, [&] { return stopping || generation != seen; });
+      if (stopping) return;
+      seen = generation;
+    }
+    work(id);
+  }
+}
+
+void SnailThreadPool::work(size_t id) {
+  size_t task;
+  while (popOrSteal(id, task)) {
+    (*job.load())(id, task);
+    if (pending.fetch_sub(1) == 1) {
+      std::lock_guard<std::mutex> lock(stateMutex);
+      done.notify_all();
+    }
+  }
+}
+
+bool SnailThreadPool::popOrSteal(size_t id, size_t &task) {
+  // Own queue: LIFO end
+  {
+    Queue &own = *queues[id];
+    std::lock_guard<std::mutex> lock(own.m);
+    if (!own.tasks.empty()) {
+      task = own.tasks.back();
+      own.tasks.pop_back();
+      return true;
+    }
+  }
+  // Victims: FIFO end, starting with the next worker
+  for (size_t k = 1; k < queues.size(); ++k) {
+    Queue &victim = *queues[(id + k) % queues.size()];
+    std::lock_guard<std::mutex> lock(victim.m);
+    if (!victim.tasks.empty()) {
+      task = victim.tasks.front();
+      victim.tasks.pop_front();
+      return true;
+    }
+  }
+  return false;
+}
+
+#else // !SNAILDB_THREADS
+
+SnailThreadPool::SnailThreadPool(size_t) {}
+SnailThreadPool::~SnailThreadPool() {}
+size_t SnailThreadPool::getThreadCount() const { return 1; }
+
+void SnailThreadPool::parallelFor(size_t count, const Body &body) {
+  for (size_t i = 0; i < count; ++i) body(0, i);
+}
+
+#endif
+
+// =========================================================
+// Morsel Kernels
+// =========================================================
+
+template <typename T>
+static void matchRange(const std::vector<T> &vals, T key, const std::vector<bool> &active,
+                       size_t begin, size_t end, std::vector<uint32_t> &out) {
+  for (size_t i = begin; i < end; ++i) {
+    if (vals[i] == key && active[i]) out.push_back((uint32_t)i);
+  }
+}
+
+template <typename T>
+static void aggregateRange(const std::vector<T> &vals, const std::vector<bool> &active,
+                           size_t begin, size_t end, SnailAggregate &acc) {
+  for (size_t i = begin; i < end; ++i) {
+    if (!active[i]) continue;
+    double v = (double)vals[i];
+    acc.count++;
+    acc.sum += v;
+    if (v < acc.min) acc.min = v;
+    if (v > acc.max) acc.max = v;
+  }
+}
+
+static void aggregateBoolRange(const InternalBoolColumn &col, const std::vector<bool> &active,
+                               size_t begin, size_t end, SnailAggregate &acc) {
+  for (size_t i = begin; i < end; ++i) {
+    if (!active[i]) continue;
+    double v = col.getBool(i) ? 1.0 : 0.0;
+    acc.count++;
+    acc.sum += v;
+    if (v < acc.min) acc.min = v;
+    if (v > acc.max) acc.max = v;
+  }
+}
+
+// =========================================================
+// SnailExecutor
+// =========================================================
+
+SnailExecutor::SnailExecutor(SnailThreadPool &pool, size_t morselRows)
+    : pool(pool), morselRows(((morselRows + 63) / 64) * 64) {
+  if (this->morselRows == 0) this->morselRows = DEFAULT_MORSEL;
+}
+
+size_t SnailExecutor::count(const SnailDB &db) const {
+  const std::vector<bool> &active = db.activeRows;
+  std::vector<size_t> counts(pool.getThreadCount(), 0);
+
+  pool.parallelFor(morselCount(active.size()), [&](size_t worker, size_t m) {
+    size_t begin = m * morselRows;
+    size_t end = std::min(begin + morselRows, active.size());
+    size_t local = 0;
+    for (size_t i = begin; i < end; ++i) {
+      if (active[i]) local++;
+    }
+    counts[worker] += local;
+  });
+
+  size_t total = 0;
+  for (size_t c : counts) total += c;
+  return total;
+}
+
+std::vector<uint32_t> SnailExecutor::filter(const SnailDB &db, SnailPredicate &pred) const {
+  std::vector<uint32_t> result;
+  if (!db.resolve(pred) || !pred.key.valid) return result;
+
+  const Column *col = pred.col.column;
+  const SnailKey &key = pred.key;
+  const std::vector<bool> &active = db.activeRows;
+
+  // One output per morsel (not per worker) so the merge keeps row order
+  size_t morsels = morselCount(db.numRows);
+  std::vector<std::vector<uint32_t>> parts(morsels);
+
+  pool.parallelFor(morsels, [&](size_t, size_t m) {
+    size_t begin = m * morselRows;
+    size_t end = std::min(begin + morselRows, db.numRows);
+    std::vector<uint32_t> &out = parts[m];
+
+    switch (col->getType()) {
+    case INT_TYPE:
+      matchRange(static_cast<const InternalIntColumn *>(col)->storage, (int)key.i,
+                 active, begin, end, out);
+      break;
+    case STR_TYPE:
+      matchRange(static_cast<const InternalStrColumn *>(col)->data, (uint16_t)key.i,
+                 active, begin, end, out);
+      break;
+    case INT64_TYPE:
+      matchRange(static_cast<const InternalInt64Column *>(col)->storage, key.l,
+                 active, begin, end, out);
+      break;
+    case FLOAT_TYPE:
+      matchRange(static_cast<const InternalFloatColumn *>(col)->storage, (float)key.d,
+                 active, begin, end, out);
+      break;
+    case DOUBLE_TYPE:
+      matchRange(static_cast<const InternalDoubleColumn *>(col)->storage, key.d,
+                 active, begin, end, out);
+      break;
+    case BOOL_TYPE:
+      for (size_t i = begin; i < end; ++i) {
+        if (col->getBool(i) == (key.i != 0) && active[i]) out.push_back((uint32_t)i);
+      }
+      break;
+    }
+  });
+
+  size_t total = 0;
+  for (const auto &p : parts) total += p.size();
+  result.reserve(total);
+  for (const auto &p : parts) result.insert(result.end(), p.begin(), p.end());
+  return result;
+}
+
+size_t SnailExecutor::countWhere(const SnailDB &db, SnailPredicate &pred) const {
+  return filter(db, pred).size();
+}
+
+bool SnailExecutor::aggregate(const SnailDB &db, const std::string &colName,
+                              SnailAggregate &out) const {
+  int idx = db.getColIndex(colName);
+  if (idx == -1) return false;
+  const Column *col = db.columns[idx].get();
+  if (col->getType() == STR_TYPE) return false;
+
+  const std::vector<bool> &active = db.activeRows;
+  SnailAggregate empty = {0, 0.0, std::numeric_limits<double>::max(),
+                          -std::numeric_limits<double>::max()};
+  std::vector<SnailAggregate> slots(pool.getThreadCount(), empty);
+
+  pool.parallelFor(morselCount(db.numRows), [&](size_t worker, size_t m) {
+    size_t begin = m * morselRows;
+    size_t end = std::min(begin + morselRows, db.numRows);
+    SnailAggregate &acc = slots[worker];
+
+    switch (col->getType()) {
+    case INT_TYPE:
+      aggregateRange(static_cast<const InternalIntColumn *>(col)->storage, active, begin, end, acc);
+      break;
+    case INT64_TYPE:
+      aggregateRange(static_cast<const InternalInt64Column *>(col)->storage, active, begin, end, acc);
+      break;
+    case FLOAT_TYPE:
+      aggregateRange(static_cast<const InternalFloatColumn *>(col)->storage, active, begin, end, acc);
+      break;
+    case DOUBLE_TYPE:
+      aggregateRange(static_cast<const InternalDoubleColumn *>(col)->storage, active, begin, end, acc);
+      break;
+    case BOOL_TYPE:
+      aggregateBoolRange(*static_cast<const InternalBoolColumn *>(col), active, begin, end, acc);
+      break;
+    case STR_TYPE:
+      break;
+    }
+  });
+
+  out = empty;
+  for (const SnailAggregate &s : slots) {
+    out.count += s.count;
+    out.sum += s.sum;
+    if (s.min < out.min) out.min = s.min;
+    if (s.max > out.max) out.max = s.max;
+  }
+  if (out.count == 0) out.min = out.max = 0.0;
+  return true;
+}
+
+void SnailExecutor::deleteOlderThan(SnailDB &db, uint32_t threshold) const {
+  const std::vector<uint32_t> &ts = db.timestamps;
+  std::vector<bool> &active = db.activeRows;
+
+  pool.parallelFor(morselCount(ts.size()), [&](size_t, size_t m) {
+    size_t begin = m * morselRows;
+    size_t end = std::min(begin + morselRows, ts.size());
+    for (size_t i = begin; i < end; ++i) {
+      if (ts[i] < threshold) active[i] = false;
+    }
+  });
+}
+
+void SnailExecutor::purge(SnailDB &db) const {
+  if (db.activeRows.empty()) return;
+
+  // Columns are independent: compact each one on its own worker
+  pool.parallelFor(db.columns.size(), [&](size_t, size_t c) {
+    db.columns[c]->compact(db.activeRows);
+  });
+
+  db.compactSystem();
+}
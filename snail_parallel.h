@@ -0,0 +1,125 @@
+// snail_parallel.h
+#ifndef SNAIL_PARALLEL_H
+#define SNAIL_PARALLEL_H
+
+#include "snaildb.h"
+#include <functional>
+
+// Threads are available on hosted builds (Linux archive tooling). On
+// Arduino targets the pool has no workers and everything runs inline on the
+// caller, so the same code compiles everywhere.
+#ifndef SNAILDB_THREADS
+#ifdef ARDUINO
+#define SNAILDB_THREADS 0
+#else
+#define SNAILDB_THREADS 1
+#endif
+#endif
+
+#if SNAILDB_THREADS
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#endif
+
+// =========================================================
+// Work-Stealing Thread Pool (v1.1)
+// =========================================================
+//
+// parallelFor(count, body) runs body(worker, task) for task in [0, count).
+// Tasks are dealt out in contiguous blocks, one deque per worker; a worker
+// that runs dry steals from the front of the others. The calling thread takes
+// part as worker 0, so 'worker' is always < getThreadCount() and can index
+// thread-local result slots.
+class SnailThreadPool {
+public:
+  typedef std::function<void(size_t worker, size_t task)> Body;
+
+  // threads = 0 uses every hardware thread; 1 runs inline on the caller
+  explicit SnailThreadPool(size_t threads = 0);
+  ~SnailThreadPool();
+
+  size_t getThreadCount() const;
+  void parallelFor(size_t count, const Body &body);
+
+private:
+  SnailThreadPool(const SnailThreadPool &);
+  SnailThreadPool &operator=(const SnailThreadPool &);
+
+#if SNAILDB_THREADS
+  struct Queue {
+    std::mutex m;
+    std::deque<size_t> tasks;
+  };
+
+  void workerLoop(size_t id);
+  void work(size_t id);
+  bool popOrSteal(size_t id, size_t &task);
+
+  std::vector<std::thread> threads;
+  std::vector<std::unique_ptr<Queue>> queues; // queues[0] is the caller's
+
+  std::mutex runMutex; // One parallelFor at a time
+  std::mutex stateMutex;
+  std::condition_variable wake;
+  std::condition_variable done;
+  std::atomic<const Body *> job;
+  std::atomic<size_t> pending;
+  uint64_t generation;
+  bool stopping;
+#endif
+};
+
+// Merged result of SnailExecutor::aggregate
+struct SnailAggregate {
+  size_t count; // Active rows aggregated
+  double sum;
+  double min;
+  double max;
+
+  double mean() const { return count ? sum / count : 0.0; }
+};
+
+// =========================================================
+// Morsel-Driven Executor (v1.1)
+// =========================================================
+//
+// Splits a table's row range into morsels and runs them on a SnailThreadPool.
+// Each worker accumulates into its own slot; slots are merged at the end.
+// Results match the single-threaded SnailDB operations.
+class SnailExecutor {
+public:
+  // Morsels are kept a multiple of 64 rows so that concurrent writes to the
+  // std::vector<bool> tombstones never share a storage word.
+  static const size_t DEFAULT_MORSEL = 16384;
+
+  explicit SnailExecutor(SnailThreadPool &pool, size_t morselRows = DEFAULT_MORSEL);
+
+  size_t getMorselRows() const { return morselRows; }
+
+  // Equivalent of SnailDB::getSize()
+  size_t count(const SnailDB &db) const;
+
+  // All active rows equal to the predicate, in row order
+  std::vector<uint32_t> filter(const SnailDB &db, SnailPredicate &pred) const;
+  size_t countWhere(const SnailDB &db, SnailPredicate &pred) const;
+
+  // count/sum/min/max over the active rows of a numeric or BOOL column.
+  // Returns false if the column is missing or is a STR column.
+  bool aggregate(const SnailDB &db, const std::string &colName, SnailAggregate &out) const;
+
+  // Equivalents of SnailDB::deleteOlderThan() and SnailDB::purge(). purge
+  // compacts the columns (and the timestamps) concurrently, one per task.
+  void deleteOlderThan(SnailDB &db, uint32_t threshold) const;
+  void purge(SnailDB &db) const;
+
+private:
+  size_t morselCount(size_t rows) const { return (rows + morselRows - 1) / morselRows; }
+
+  SnailThreadPool &pool;
+  size_t morselRows;
+};
+
+#endif // SNAIL_PARALLEL_H
@@ -0,0 +1,876 @@
+#include "snail_query.h"
+#include <algorithm>
+#include <cmath>
+
+// =========================================================
+// Predicate Kernels
+// =========================================================
+
+// lo/hi bounds of one compiled predicate; negate turns it into NOT (x in b)
+template <typename B> struct SnailBounds {
+  bool hasLo, loIncl, hasHi, hiIncl, negate;
+  B lo, hi;
+
+  template <typename T> bool test(T v) const {
+    bool ok = (!hasLo || (loIncl ? !(v < lo) : lo < v)) &&
+              (!hasHi || (hiIncl ? !(hi < v) : v < hi));
+    return ok != negate;
+  }
+
+  template <typename C> SnailBounds<C> as() const {
+    SnailBounds<C> b = { hasLo, loIncl, hasHi, hiIncl, negate, (C)lo, (C)hi };
+    return b;
+  }
+};
+
+// Rows [begin, end) of a sorted vector that fall inside b (b.negate unset)
+template <typename T, typename B>
+static void boundSpan(const std::vector<T> &vals, const SnailBounds<B> &b, size_t &begin,
+                      size_t &end) {
+  auto below = [](const T &v, const B &k) { return v < k; };
+  auto above = [](const B &k, const T &v) { return k < v; };
+  auto first = vals.begin();
+  begin = 0;
+  end = vals.size();
+  if (b.hasLo) {
+    begin = (b.loIncl ? std::lower_bound(first, vals.end(), b.lo, below)
+                      : std::upper_bound(first, vals.end(), b.lo, above)) - first;
+  }
+  if (b.hasHi) {
+    end = (b.hiIncl ? std::upper_bound(first, vals.end(), b.hi, above)
+                    : std::lower_bound(first, vals.end(), b.hi, below)) - first;
+  }
+  if (end < begin) end = begin;
+}
+
+struct SnailQuery::Compiled {
+  const Predicate *src;
+  const Column *col; // nullptr: timestamp range
+  ColumnType type;
+  SnailBounds<int64_t> ints; // INT, INT64, BOOL, timestamps
+  SnailBounds<double> reals; // FLOAT, DOUBLE
+  SnailTokenSet tokens;      // STR
+
+  SnailAccessPath path;
+  size_t begin, end;               // PATH_BINARY / PATH_TIME_RANGE
+  std::vector<uint32_t> indexRows; // PATH_INDEX
+  size_t estimate;
+};
+
+// Appends the active rows of [begin, end) that pass the test
+struct SnailQuery::SpanSelect {
+  size_t begin, end;
+  const std::vector<bool> &active;
+  std::vector<uint32_t> &sel;
+
+  template <typename Test> void operator()(Test test) {
+    for (size_t i = begin; i < end; ++i) {
+      if (active[i] && test(i)) sel.push_back((uint32_t)i);
+    }
+  }
+};
+
+// Keeps the selected rows that pass the test
+struct SnailQuery::Refine {
+  std::vector<uint32_t> &sel;
+
+  template <typename Test> void operator()(Test test) {
+    size_t dst = 0;
+    for (size_t i = 0; i < sel.size(); ++i) {
+      if (test(sel[i])) sel[dst++] = sel[i];
+    }
+    sel.resize(dst);
+  }
+};
+
+// Calls act(test) with a row test specialised for the column's storage, so
+// the loops in the actions run without virtual calls
+template <typename Action> void SnailQuery::dispatch(const Compiled &c, Action &act) const {
+  if (!c.col) {
+    const std::vector<uint32_t> &ts = db.timestamps;
+    SnailBounds<int64_t> b = c.ints;
+    act([&ts, b](size_t r) { return b.test(ts[r]); });
+    return;
+  }
+
+  switch (c.type) {
+  case INT_TYPE: {
+    const std::vector<int> &vals = static_cast<const InternalIntColumn *>(c.col)->storage;
+    SnailBounds<int64_t> b = c.ints;
+    act([&vals, b](size_t r) { return b.test(vals[r]); });
+    break;
+  }
+  case INT64_TYPE: {
+    const std::vector<int64_t> &vals = static_cast<const InternalInt64Column *>(c.col)->storage;
+    SnailBounds<int64_t> b = c.ints;
+    act([&vals, b](size_t r) { return b.test(vals[r]); });
+    break;
+  }
+  case FLOAT_TYPE: {
+    // Compare as float, like findRow(): "21.1" must match the stored 21.1f
+    const std::vector<float> &vals = static_cast<const InternalFloatColumn *>(c.col)->storage;
+    SnailBounds<float> b = c.reals.as<float>();
+    act([&vals, b](size_t r) { return b.test(vals[r]); });
+    break;
+  }
+  case DOUBLE_TYPE: {
+    const std::vector<double> &vals = static_cast<const InternalDoubleColumn *>(c.col)->storage;
+    SnailBounds<double> b = c.reals;
+    act([&vals, b](size_t r) { return b.test(vals[r]); });
+    break;
+  }
+  case BOOL_TYPE: {
+    const std::vector<uint8_t> &bits = static_cast<const InternalBoolColumn *>(c.col)->bits;
+    SnailBounds<int64_t> b = c.ints;
+    act([&bits, b](size_t r) { return b.test((int64_t)((bits[r >> 3] >> (r & 7)) & 1u)); });
+    break;
+  }
+  case STR_TYPE: {
+    const std::vector<uint16_t> &data = static_cast<const InternalStrColumn *>(c.col)->data;
+    const SnailTokenSet &set = c.tokens;
+    if (set.isRange) {
+      uint16_t lo = set.lo, hi = set.hi;
+      act([&data, lo, hi](size_t r) { return data[r] >= lo && data[r] < hi; });
+    } else {
+      act([&data, &set](size_t r) { return set.contains(data[r]); });
+    }
+    break;
+  }
+  }
+}
+
+// =========================================================
+// SnailQuery
+// =========================================================
+
+SnailQuery &SnailQuery::where(const std::string &colName, SnailOp op, const std::string &value) {
+  Predicate p = { colName, op, value, std::string(), 0, 0 };
+  preds.push_back(p);
+  return *this;
+}
+
+SnailQuery &SnailQuery::whereBetween(const std::string &colName, const std::string &lo,
+                                     const std::string &hi) {
+  Predicate p = { colName, OP_BETWEEN, lo, hi, 0, 0 };
+  preds.push_back(p);
+  return *this;
+}
+
+SnailQuery &SnailQuery::whereTime(uint32_t from, uint32_t to) {
+  Predicate p = { std::string(), OP_BETWEEN, std::string(), std::string(), from, to };
+  preds.push_back(p);
+  return *this;
+}
+
+SnailQuery &SnailQuery::select(const std::string &colName) {
+  projection.push_back(colName);
+  return *this;
+}
+
+// Sets lo/hi from the operator; v2 is only used by OP_BETWEEN
+template <typename B>
+static void setBounds(SnailBounds<B> &b, SnailOp op, B v, B v2) {
+  b.hasLo = b.hasHi = b.negate = false;
+  b.loIncl = b.hiIncl = true;
+  b.lo = b.hi = v;
+  switch (op) {
+  case OP_NE: b.negate = true; // fall through
+  case OP_EQ: b.hasLo = b.hasHi = true; break;
+  case OP_LT: b.hasHi = true; b.hiIncl = false; break;
+  case OP_LE: b.hasHi = true; break;
+  case OP_GT: b.hasLo = true; b.loIncl = false; break;
+  case OP_GE: b.hasLo = true; break;
+  case OP_BETWEEN: b.hasLo = b.hasHi = true; b.hi = v2; break;
+  case OP_PREFIX: break;
+  }
+}
+
+bool SnailQuery::compile(const Predicate &pred, Compiled &c) const {
+  c.src = &pred;
+  c.path = PATH_SCAN;
+  c.begin = 0;
+  c.end = db.numRows;
+  c.estimate = db.numRows;
+
+  if (pred.colName.empty()) {
+    c.col = nullptr;
+    c.type = INT64_TYPE;
+    setBounds<int64_t>(c.ints, OP_BETWEEN, pred.tsFrom, pred.tsTo);
+    return true;
+  }
+
+  int idx = db.getColIndex(pred.colName);
+  if (idx == -1) return false;
+  c.col = db.columns[idx].get();
+  c.type = c.col->getType();
+  if (pred.op == OP_PREFIX && c.type != STR_TYPE) return false;
+
+  SnailKey k = c.col->resolveKey(pred.value);
+  SnailKey k2 = pred.op == OP_BETWEEN ? c.col->resolveKey(pred.value2) : k;
+
+  switch (c.type) {
+  case INT_TYPE:
+  case BOOL_TYPE:
+    setBounds<int64_t>(c.ints, pred.op, k.i, k2.i);
+    break;
+  case INT64_TYPE:
+    setBounds<int64_t>(c.ints, pred.op, k.l, k2.l);
+    break;
+  case FLOAT_TYPE:
+  case DOUBLE_TYPE:
+    setBounds<double>(c.reals, pred.op, k.d, k2.d);
+    break;
+  case STR_TYPE: {
+    const InternalStrColumn *str = static_cast<const InternalStrColumn *>(c.col);
+    const std::string &v = pred.value;
+    SnailTokenSet &set = c.tokens;
+    switch (pred.op) {
+    case OP_EQ:
+      // A single token is a range whatever the dictionary order
+      set.isRange = true;
+      set.lo = k.valid ? (uint16_t)k.i : 0;
+      set.hi = k.valid ? (uint16_t)(k.i + 1) : 0;
+      break;
+    case OP_NE:
+      set.isRange = false;
+      set.mask.assign(str->dictionary.size(), 1);
+      if (k.valid) set.mask[k.i] = 0;
+      break;
+    case OP_LT: set = str->matchRange(nullptr, false, &v, false); break;
+    case OP_LE: set = str->matchRange(nullptr, false, &v, true); break;
+    case OP_GT: set = str->matchRange(&v, false, nullptr, false); break;
+    case OP_GE: set = str->matchRange(&v, true, nullptr, false); break;
+    case OP_BETWEEN: set = str->matchRange(&v, true, &pred.value2, true); break;
+    case OP_PREFIX: set = str->matchPrefix(v); break;
+    }
+    break;
+  }
+  }
+  return true;
+}
+
+void SnailQuery::plan(Compiled &c) const {
+  size_t n = db.numRows;
+
+  if (!c.col) {
+    if (db.tsSorted) {
+      c.path = PATH_TIME_RANGE;
+      boundSpan(db.timestamps, c.ints, c.begin, c.end);
+      c.estimate = c.end - c.begin;
+    } else {
+      c.estimate = n / 4;
+    }
+    return;
+  }
+
+  bool negate = c.type == STR_TYPE ? false : (c.type == FLOAT_TYPE || c.type == DOUBLE_TYPE)
+                                                 ? c.reals.negate
+                                                 : c.ints.negate;
+
+  if (c.type == STR_TYPE) {
+    const InternalStrColumn *str = static_cast<const InternalStrColumn *>(c.col);
+    const SnailTokenSet &set = c.tokens;
+    size_t dictSize = str->dictionary.size();
+    size_t matching = 0;
+    if (set.isRange) {
+      matching = set.hi - set.lo;
+    } else {
+      for (uint8_t m : set.mask) matching += m ? 1 : 0;
+    }
+    if (matching == 0) {
+      c.path = PATH_EMPTY;
+      c.estimate = 0;
+      return;
+    }
+    if (set.isRange && str->sorted) {
+      c.path = PATH_BINARY;
+      c.begin = std::lower_bound(str->data.begin(), str->data.end(), set.lo) - str->data.begin();
+      c.end = std::lower_bound(str->data.begin() + c.begin, str->data.end(), set.hi) -
+              str->data.begin();
+      c.estimate = c.end - c.begin;
+      return;
+    }
+    if (c.src->op == OP_EQ) {
+      SnailKey k = { true, set.lo, 0, 0.0 };
+      if (str->indexLookup(k, c.indexRows)) {
+        c.path = PATH_INDEX;
+        c.estimate = c.indexRows.size();
+        return;
+      }
+    }
+    // Dictionary statistics: share of distinct strings that match
+    c.estimate = dictSize ? n * matching / dictSize : 0;
+    return;
+  }
+
+  if (!negate && c.col->isSorted() && c.type != BOOL_TYPE) {
+    c.path = PATH_BINARY;
+    switch (c.type) {
+    case INT_TYPE:
+      boundSpan(static_cast<const InternalIntColumn *>(c.col)->storage, c.ints, c.begin, c.end);
+      break;
+    case INT64_TYPE:
+      boundSpan(static_cast<const InternalInt64Column *>(c.col)->storage, c.ints, c.begin, c.end);
+      break;
+    case FLOAT_TYPE:
+      boundSpan(static_cast<const InternalFloatColumn *>(c.col)->storage, c.reals.as<float>(),
+                c.begin, c.end);
+      break;
+    default:
+      boundSpan(static_cast<const InternalDoubleColumn *>(c.col)->storage, c.reals, c.begin,
+                c.end);
+      break;
+    }
+    c.estimate = c.end - c.begin;
+    return;
+  }
+
+  if (c.src->op == OP_EQ && c.type == INT_TYPE) {
+    SnailKey k = { true, (int32_t)c.ints.lo, 0, 0.0 };
+    if (static_cast<const InternalIntColumn *>(c.col)->indexLookup(k, c.indexRows)) {
+      c.path = PATH_INDEX;
+      c.estimate = c.indexRows.size();
+      return;
+    }
+  }
+
+  // No statistics: the classic 1/10 (equality), 1/3 (open range) and
+  // 1/4 (closed range) guesses, 1/2 for booleans
+  switch (c.src->op) {
+  case OP_EQ: c.estimate = c.type == BOOL_TYPE ? n / 2 : n / 10; break;
+  case OP_NE: c.estimate = c.type == BOOL_TYPE ? n / 2 : n - n / 10; break;
+  case OP_BETWEEN: c.estimate = n / 4; break;
+  default: c.estimate = n / 3; break;
+  }
+}
+
+bool SnailQuery::run(SnailQueryResult &out) const {
+  out.rows.clear();
+  out.cols.clear();
+  out.plan.clear();
+
+  std::vector<Compiled> compiled(preds.size());
+  for (size_t i = 0; i < preds.size(); ++i) {
+    if (!compile(preds[i], compiled[i])) return false;
+  }
+  for (const std::string &name : projection) {
+    if (db.getColIndex(name) == -1) return false;
+  }
+
+  // 1. Access paths. Row spans (sorted columns / timestamps) are exact and
+  //    are intersected before anything touches a row.
+  size_t begin = 0, end = db.numRows;
+  std::vector<Compiled *> spans, rest;
+  for (Compiled &c : compiled) {
+    plan(c);
+    if (c.path == PATH_BINARY || c.path == PATH_TIME_RANGE || c.path == PATH_EMPTY) {
+      spans.push_back(&c);
+    } else {
+      rest.push_back(&c);
+    }
+  }
+  auto byEstimate = [](const Compiled *a, const Compiled *b) { return a->estimate < b->estimate; };
+  std::stable_sort(spans.begin(), spans.end(), byEstimate);
+  std::stable_sort(rest.begin(), rest.end(), byEstimate);
+
+  bool empty = false;
+  for (Compiled *c : spans) {
+    out.plan.push_back({ c->src->colName, c->src->op, c->path, c->estimate });
+    if (c->path == PATH_EMPTY) {
+      empty = true;
+      break;
+    }
+    begin = std::max(begin, c->begin);
+    end = std::min(end, c->end);
+  }
+  if (end < begin) end = begin;
+  if (empty || begin == end) {
+    materialize(out);
+    return true;
+  }
+
+  // 2. Seed the selection with the most selective remaining predicate. An
+  //    index hit list is used directly when it is smaller than the span.
+  std::vector<uint32_t> &sel = out.rows;
+  size_t next = 0;
+  if (!rest.empty()) {
+    Compiled *c = rest[0];
+    out.plan.push_back({ c->src->colName, c->src->op, c->path, c->estimate });
+    if (c->path == PATH_INDEX && c->indexRows.size() < end - begin) {
+      for (uint32_t r : c->indexRows) {
+        if (r >= begin && r < end && db.activeRows[r]) sel.push_back(r);
+      }
+    } else {
+      SpanSelect act = { begin, end, db.activeRows, sel };
+      dispatch(*c, act);
+    }
+    next = 1;
+  } else {
+    for (size_t i = begin; i < end; ++i) {
+      if (db.activeRows[i]) sel.push_back((uint32_t)i);
+    }
+  }
+
+  // 3. Refine: each later predicate only tests the surviving rows
+  for (size_t i = next; i < rest.size() && !sel.empty(); ++i) {
+    Compiled *c = rest[i];
+    out.plan.push_back({ c->src->colName, c->src->op, PATH_SCAN, c->estimate });
+    Refine act = { sel };
+    dispatch(*c, act);
+  }
+
+  materialize(out);
+  return true;
+}
+
+// Gathers the projected columns for the selected rows only
+void SnailQuery::materialize(SnailQueryResult &out) const {
+  std::vector<int> cols;
+  if (projection.empty()) {
+    for (size_t i = 0; i < db.columns.size(); ++i) cols.push_back((int)i);
+  } else {
+    for (const std::string &name : projection) cols.push_back(db.getColIndex(name));
+  }
+
+  const std::vector<uint32_t> &rows = out.rows;
+  for (int idx : cols) {
+    const Column *col = db.columns[idx].get();
+    SnailQueryResult::Col rc;
+    rc.name = db.colNames[idx];
+    rc.type = col->getType();
+    rc.dict = nullptr;
+
+    switch (rc.type) {
+    case INT_TYPE: {
+      const std::vector<int> &vals = static_cast<const InternalIntColumn *>(col)->storage;
+      rc.ints.reserve(rows.size());
+      for (uint32_t r : rows) rc.ints.push_back(vals[r]);
+      break;
+    }
+    case INT64_TYPE: {
+      const std::vector<int64_t> &vals = static_cast<const InternalInt64Column *>(col)->storage;
+      rc.ints.reserve(rows.size());
+      for (uint32_t r : rows) rc.ints.push_back(vals[r]);
+      break;
+    }
+    case BOOL_TYPE:
+      rc.ints.reserve(rows.size());
+      for (uint32_t r : rows) rc.ints.push_back(col->getBool(r) ? 1 : 0);
+      break;
+    case FLOAT_TYPE: {
+      const std::vector<float> &vals = static_cast<const InternalFloatColumn *>(col)->storage;
+      rc.reals.reserve(rows.size());
+      for (uint32_t r : rows) rc.reals.push_back(vals[r]);
+      break;
+    }
+    case DOUBLE_TYPE: {
+      const std::vector<double> &vals = static_cast<const InternalDoubleColumn *>(col)->storage;
+      rc.reals.reserve(rows.size());
+      for (uint32_t r : rows) rc.reals.push_back(vals[r]);
+      break;
+    }
+    case STR_TYPE: {
+      const InternalStrColumn *str = static_cast<const InternalStrColumn *>(col);
+      rc.dict = &str->dictionary;
+      rc.tokens.reserve(rows.size());
+      for (uint32_t r : rows) rc.tokens.push_back(str->data[r]);
+      break;
+    }
+    }
+    out.cols.push_back(rc);
+  }
+}
+
+// =========================================================
+// SnailQueryResult
+// =========================================================
+
+int64_t SnailQueryResult::getInt64(size_t row, size_t col) const {
+  if (col >= cols.size() || row >= rows.size()) return 0;
+  const Col &c = cols[col];
+  if (!c.ints.empty()) return c.ints[row];
+  if (!c.reals.empty()) return (int64_t)c.reals[row];
+  return 0;
+}
+
+double SnailQueryResult::getDouble(size_t row, size_t col) const {
+  if (col >= cols.size() || row >= rows.size()) return 0.0;
+  const Col &c = cols[col];
+  if (!c.reals.empty()) return c.reals[row];
+  if (!c.ints.empty()) return (double)c.ints[row];
+  return 0.0;
+}
+
+const std::string &SnailQueryResult::getStr(size_t row, size_t col) const {
+  static const std::string empty;
+  if (col >= cols.size() || row >= rows.size()) return empty;
+  const Col &c = cols[col];
+  if (!c.dict || c.tokens[row] >= c.dict->size()) return empty;
+  return (*c.dict)[c.tokens[row]];
+}
+
+// =========================================================
+// SnailOrder
+// =========================================================
+
+bool SnailOrder::orderBy(const std::string &colName, bool ascending, size_t limit) {
+  return buildFor(colName, nullptr, ascending, limit);
+}
+
+bool SnailOrder::orderBy(const std::string &colName, const std::vector<uint32_t> &rows,
+                         bool ascending, size_t limit) {
+  return buildFor(colName, &rows, ascending, limit);
+}
+
+bool SnailOrder::buildFor(const std::string &colName, const std::vector<uint32_t> *rows,
+                          bool ascending, size_t limit) {
+  perm.clear();
+  cursor = 0;
+  int idx = db.getColIndex(colName);
+  if (idx == -1) return false;
+  const Column *col = db.columns[idx].get();
+
+  // Keys are read straight from the column vectors
+  switch (col->getType()) {
+  case INT_TYPE: {
+    const std::vector<int> &vals = static_cast<const InternalIntColumn *>(col)->storage;
+    build([&vals](uint32_t r) { return vals[r]; }, rows, ascending, limit);
+    break;
+  }
+  case INT64_TYPE: {
+    const std::vector<int64_t> &vals = static_cast<const InternalInt64Column *>(col)->storage;
+    build([&vals](uint32_t r) { return vals[r]; }, rows, ascending, limit);
+    break;
+  }
+  case FLOAT_TYPE: {
+    const std::vector<float> &vals = static_cast<const InternalFloatColumn *>(col)->storage;
+    build([&vals](uint32_t r) { return vals[r]; }, rows, ascending, limit);
+    break;
+  }
+  case DOUBLE_TYPE: {
+    const std::vector<double> &vals = static_cast<const InternalDoubleColumn *>(col)->storage;
+    build([&vals](uint32_t r) { return vals[r]; }, rows, ascending, limit);
+    break;
+  }
+  case BOOL_TYPE:
+    build([col](uint32_t r) { return col->getBool(r); }, rows, ascending, limit);
+    break;
+  case STR_TYPE: {
+    // Compare small integer ranks, never the strings themselves
+    const InternalStrColumn *str = static_cast<const InternalStrColumn *>(col);
+    const std::vector<uint16_t> &data = str->data;
+    std::vector<uint16_t> ranks = str->dictionaryRanks();
+    build([&data, &ranks](uint32_t r) { return ranks[data[r]]; }, rows, ascending, limit);
+    break;
+  }
+  }
+  return true;
+}
+
+// NaN has no place in '<': ordered views give it a fixed one (last)
+template <typename T> static bool isNanKey(T) { return false; }
+static bool isNanKey(float v) { return std::isnan(v); }
+static bool isNanKey(double v) { return std::isnan(v); }
+
+template <typename KeyFn>
+void SnailOrder::build(KeyFn key, const std::vector<uint32_t> *rows, bool ascending,
+                       size_t limit) {
+  // Strict weak order on rows: by key (NaN last), ties by row id
+  auto before = [&key, ascending](uint32_t a, uint32_t b) {
+    bool nanA = isNanKey(key(a)), nanB = isNanKey(key(b));
+    if (nanA != nanB) return nanB;
+    if (key(a) < key(b)) return ascending;
+    if (key(b) < key(a)) return !ascending;
+    return a < b;
+  };
+
+  const std::vector<bool> &active = db.activeRows;
+  size_t n = rows ? rows->size() : db.numRows;
+
+  if (limit == 0 || limit >= n) {
+    perm.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+      uint32_t r = rows ? (*rows)[i] : (uint32_t)i;
+      if (r < active.size() && active[r]) perm.push_back(r);
+    }
+    std::sort(perm.begin(), perm.end(), before);
+    return;
+  }
+
+  // Top-K: a heap of the best 'limit' rows so far, worst on top
+  perm.reserve(limit);
+  for (size_t i = 0; i < n; ++i) {
+    uint32_t r = rows ? (*rows)[i] : (uint32_t)i;
+    if (r >= active.size() || !active[r]) continue;
+    if (perm.size() < limit) {
+      perm.push_back(r);
+      std::push_heap(perm.begin(), perm.end(), before);
+    } else if (before(r, perm.front())) {
+      std::pop_heap(perm.begin(), perm.end(), before);
+      perm.back() = r;
+      std::push_heap(perm.begin(), perm.end(), before);
+    }
+  }
+  std::sort_heap(perm.begin(), perm.end(), before);
+}
+
+// =========================================================
+// SnailJoin
+// =========================================================
+
+// Integer key read straight from an INT or INT64 column
+template <typename T> struct SnailIntKey {
+  const std::vector<T> &vals;
+  int64_t operator()(size_t r) const { return vals[r]; }
+};
+
+static uint32_t joinHash(int64_t key, int shift) {
+  // Fibonacci hashing: the top bits of the product pick the bucket
+  return (uint32_t)(((uint64_t)key * 0x9E3779B97F4A7C15ull) >> shift);
+}
+
+template <typename BuildKey, typename ProbeKey>
+void SnailJoin::intJoin(const SnailDB &build, BuildKey buildKey, const SnailDB &probe,
+                        ProbeKey probeKey, std::vector<uint32_t> &buildOut,
+                        std::vector<uint32_t> &probeOut) const {
+  // Build: chained table with at least two buckets per row
+  std::vector<uint32_t> rows;
+  std::vector<int64_t> keys;
+  for (size_t r = 0; r < build.numRows; ++r) {
+    if (!build.activeRows[r]) continue;
+    rows.push_back((uint32_t)r);
+    keys.push_back(buildKey(r));
+  }
+  int bits = 1;
+  while (((size_t)1 << bits) < rows.size() * 2) bits++;
+  int shift = 64 - bits;
+  std::vector<int32_t> head((size_t)1 << bits, -1);
+  std::vector<int32_t> next(rows.size());
+  // Inserted back to front so every chain lists its rows in row order
+  for (size_t i = rows.size(); i-- > 0;) {
+    uint32_t h = joinHash(keys[i], shift);
+    next[i] = head[h];
+    head[h] = (int32_t)i;
+  }
+
+  // Probe: hash a whole batch, then walk the chains
+  uint32_t probeRows[PROBE_BATCH];
+  int64_t probeKeys[PROBE_BATCH];
+  int32_t slots[PROBE_BATCH];
+  size_t r = 0;
+  while (r < probe.numRows) {
+    size_t m = 0;
+    for (; r < probe.numRows && m < PROBE_BATCH; ++r) {
+      if (!probe.activeRows[r]) continue;
+      probeRows[m] = (uint32_t)r;
+      probeKeys[m] = probeKey(r);
+      m++;
+    }
+    for (size_t j = 0; j < m; ++j) slots[j] = head[joinHash(probeKeys[j], shift)];
+    for (size_t j = 0; j < m; ++j) {
+      for (int32_t e = slots[j]; e != -1; e = next[e]) {
+        if (keys[e] == probeKeys[j]) {
+          buildOut.push_back(rows[e]);
+          probeOut.push_back(probeRows[j]);
+        }
+      }
+    }
+  }
+}
+
+void SnailJoin::strJoin(const SnailDB &build, const InternalStrColumn &buildCol,
+                        const SnailDB &probe, const InternalStrColumn &probeCol,
+                        std::vector<uint32_t> &buildOut, std::vector<uint32_t> &probeOut) const {
+  // Build: rows chained per token; the token is the bucket
+  const std::vector<uint16_t> &buildData = buildCol.data;
+  std::vector<int32_t> head(buildCol.dictionary.size(), -1);
+  std::vector<int32_t> next(build.numRows, -1);
+  for (size_t r = build.numRows; r-- > 0;) {
+    if (!build.activeRows[r]) continue;
+    uint16_t t = buildData[r];
+    next[r] = head[t];
+    head[t] = (int32_t)r;
+  }
+
+  // Probe token -> build token, resolved once per dictionary entry by binary
+  // search over the build dictionary in string order
+  const std::vector<std::string> &buildDict = buildCol.dictionary;
+  std::vector<uint16_t> order(buildDict.size());
+  for (size_t t = 0; t < order.size(); ++t) order[t] = (uint16_t)t;
+  if (!buildCol.dictSorted) {
+    std::sort(order.begin(), order.end(),
+              [&buildDict](uint16_t a, uint16_t b) { return buildDict[a] < buildDict[b]; });
+  }
+  const std::vector<std::string> &probeDict = probeCol.dictionary;
+  std::vector<int32_t> tokenMap(probeDict.size(), -1);
+  for (size_t t = 0; t < probeDict.size(); ++t) {
+    auto it = std::lower_bound(order.begin(), order.end(), probeDict[t],
+                               [&buildDict](uint16_t a, const std::string &v) {
+                                 return buildDict[a] < v;
+                               });
+    if (it != order.end() && buildDict[*it] == probeDict[t]) tokenMap[t] = *it;
+  }
+
+  // Probe: map a whole batch of tokens, then walk the chains
+  const std::vector<uint16_t> &probeData = probeCol.data;
+  uint32_t probeRows[PROBE_BATCH];
+  int32_t slots[PROBE_BATCH];
+  size_t r = 0;
+  while (r < probe.numRows) {
+    size_t m = 0;
+    for (; r < probe.numRows && m < PROBE_BATCH; ++r) {
+      if (!probe.activeRows[r]) continue;
+      probeRows[m++] = (uint32_t)r;
+    }
+    for (size_t j = 0; j < m; ++j) {
+      int32_t bt = tokenMap[probeData[probeRows[j]]];
+      slots[j] = bt == -1 ? -1 : head[bt];
+    }
+    for (size_t j = 0; j < m; ++j) {
+      for (int32_t e = slots[j]; e != -1; e = next[e]) {
+        buildOut.push_back((uint32_t)e);
+        probeOut.push_back(probeRows[j]);
+      }
+    }
+  }
+}
+
+bool SnailJoin::run(SnailJoinResult &out) const {
+  out.left.clear();
+  out.right.clear();
+
+  int li = left.getColIndex(leftCol);
+  int ri = right.getColIndex(rightCol);
+  if (li == -1 || ri == -1) return false;
+  const Column *lc = left.columns[li].get();
+  const Column *rc = right.columns[ri].get();
+  ColumnType lt = lc->getType(), rt = rc->getType();
+
+  // Build on the smaller side
+  bool leftBuilds = left.getSize() <= right.getSize();
+  const SnailDB &build = leftBuilds ? left : right;
+  const SnailDB &probe = leftBuilds ? right : left;
+  const Column *bc = leftBuilds ? lc : rc;
+  const Column *pc = leftBuilds ? rc : lc;
+  std::vector<uint32_t> &buildOut = leftBuilds ? out.left : out.right;
+  std::vector<uint32_t> &probeOut = leftBuilds ? out.right : out.left;
+
+  if (lt == STR_TYPE && rt == STR_TYPE) {
+    strJoin(build, *static_cast<const InternalStrColumn *>(bc), probe,
+            *static_cast<const InternalStrColumn *>(pc), buildOut, probeOut);
+    return true;
+  }
+
+  bool integral = (lt == INT_TYPE || lt == INT64_TYPE) && (rt == INT_TYPE || rt == INT64_TYPE);
+  if (!integral) return false;
+
+  const std::vector<int> *bInt = nullptr, *pInt = nullptr;
+  const std::vector<int64_t> *bLong = nullptr, *pLong = nullptr;
+  if (bc->getType() == INT_TYPE) bInt = &static_cast<const InternalIntColumn *>(bc)->storage;
+  else bLong = &static_cast<const InternalInt64Column *>(bc)->storage;
+  if (pc->getType() == INT_TYPE) pInt = &static_cast<const InternalIntColumn *>(pc)->storage;
+  else pLong = &static_cast<const InternalInt64Column *>(pc)->storage;
+
+  if (bInt && pInt) {
+    intJoin(build, SnailIntKey<int>{*bInt}, probe, SnailIntKey<int>{*pInt}, buildOut, probeOut);
+  } else if (bInt) {
+    intJoin(build, SnailIntKey<int>{*bInt}, probe, SnailIntKey<int64_t>{*pLong}, buildOut,
+            probeOut);
+  } else if (pInt) {
+    intJoin(build, SnailIntKey<int64_t>{*bLong}, probe, SnailIntKey<int>{*pInt}, buildOut,
+            probeOut);
+  } else {
+    intJoin(build, SnailIntKey<int64_t>{*bLong}, probe, SnailIntKey<int64_t>{*pLong}, buildOut,
+            probeOut);
+  }
+  return true;
+}
+
+bool SnailJoin::materialize(const SnailJoinResult &rows, const std::vector<std::string> &leftCols,
+                            const std::vector<std::string> &rightCols, SnailDB &out) const {
+  if (out.getColCount() != 0) return false;
+
+  struct Source {
+    const SnailDB *db;
+    int idx;
+    const std::vector<uint32_t> *rows;
+  };
+  std::vector<Source> sources;
+  std::vector<std::string> names;
+  for (size_t side = 0; side < 2; ++side) {
+    const SnailDB &db = side == 0 ? left : right;
+    const std::vector<std::string> &cols = side == 0 ? leftCols : rightCols;
+    for (const std::string &name : cols) {
+      int idx = db.getColIndex(name);
+      if (idx == -1 || std::find(names.begin(), names.end(), name) != names.end()) return false;
+      Source src = { &db, idx, side == 0 ? &rows.left : &rows.right };
+      sources.push_back(src);
+      names.push_back(name);
+    }
+  }
+
+  // One bulk append per column, like insertBatch()
+  size_t n = rows.size();
+  for (const Source &src : sources) {
+    const ColumnInfo &info = src.db->colInfos[src.idx];
+    const Column *col = src.db->columns[src.idx].get();
+    const std::vector<uint32_t> &ids = *src.rows;
+    out.addColProp(info.name, info.max_length, info.type, info.orderedDict);
+    Column *dst = out.columns.back().get();
+    dst->reserve(n);
+
+    switch (info.type) {
+    case INT_TYPE: {
+      const std::vector<int> &vals = static_cast<const InternalIntColumn *>(col)->storage;
+      std::vector<int> tmp(n);
+      for (size_t i = 0; i < n; ++i) tmp[i] = vals[ids[i]];
+      dst->addInts(tmp.data(), n);
+      break;
+    }
+    case INT64_TYPE: {
+      const std::vector<int64_t> &vals = static_cast<const InternalInt64Column *>(col)->storage;
+      std::vector<int64_t> tmp(n);
+      for (size_t i = 0; i < n; ++i) tmp[i] = vals[ids[i]];
+      dst->addInt64s(tmp.data(), n);
+      break;
+    }
+    case FLOAT_TYPE: {
+      const std::vector<float> &vals = static_cast<const InternalFloatColumn *>(col)->storage;
+      std::vector<float> tmp(n);
+      for (size_t i = 0; i < n; ++i) tmp[i] = vals[ids[i]];
+      dst->addFloats(tmp.data(), n);
+      break;
+    }
+    case DOUBLE_TYPE: {
+      const std::vector<double> &vals = static_cast<const InternalDoubleColumn *>(col)->storage;
+      std::vector<double> tmp(n);
+      for (size_t i = 0; i < n; ++i) tmp[i] = vals[ids[i]];
+      dst->addDoubles(tmp.data(), n);
+      break;
+    }
+    case BOOL_TYPE: {
+      std::unique_ptr<bool[]> tmp(new bool[n ? n : 1]);
+      for (size_t i = 0; i < n; ++i) tmp[i] = col->getBool(ids[i]);
+      dst->addBools(tmp.get(), n);
+      break;
+    }
+    case STR_TYPE: {
+      // Pointers into the source dictionary: no string copies until the
+      // destination dictionary takes each distinct value once
+      const InternalStrColumn *str = static_cast<const InternalStrColumn *>(col);
+      std::vector<const char *> tmp(n);
+      for (size_t i = 0; i < n; ++i) tmp[i] = str->dictionary[str->data[ids[i]]].c_str();
+      dst->addStrs(tmp.data(), n);
+      break;
+    }
+    }
+  }
+
+  out.activeRows.assign(n, true);
+  out.timestamps.resize(n);
+  for (size_t i = 0; i < n; ++i) out.timestamps[i] = left.timestamps[rows.left[i]];
+  out.tsSorted = std::is_sorted(out.timestamps.begin(), out.timestamps.end());
+  out.numRows = n;
+  out.cursor = 0;
+  return true;
+}
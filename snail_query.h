@@ -0,0 +1,272 @@
+// snail_query.h
+#ifndef SNAIL_QUERY_H
+#define SNAIL_QUERY_H
+
+#include "snaildb.h"
+
+enum SnailOp {
+  OP_EQ,
+  OP_NE,
+  OP_LT,
+  OP_LE,
+  OP_GT,
+  OP_GE,
+  OP_BETWEEN, // Inclusive on both ends
+  OP_PREFIX   // STR columns only
+};
+
+// How a predicate is evaluated
+enum SnailAccessPath {
+  PATH_EMPTY,      // Cannot match (e.g. string not in the dictionary)
+  PATH_BINARY,     // Sorted column: binary-searched row span
+  PATH_TIME_RANGE, // Sorted timestamps: binary-searched row span
+  PATH_INDEX,      // Hash / token index lookup
+  PATH_SCAN        // Evaluated row by row over the current selection
+};
+
+// One predicate of an executed plan, in evaluation order
+struct SnailPlanStep {
+  std::string column; // "" for the timestamp range
+  SnailOp op;
+  SnailAccessPath path;
+  size_t estimate; // Rows expected to pass (exact for spans and index hits)
+};
+
+// Result of SnailQuery::run(). Only the projected columns are gathered, and
+// only for the surviving rows. Strings are kept as tokens: getStr() returns
+// a reference into the column's dictionary, which stays valid until the
+// table is modified.
+class SnailQueryResult {
+  friend class SnailQuery;
+
+public:
+  size_t size() const { return rows.size(); }
+  size_t getColCount() const { return cols.size(); }
+  const std::string &getColName(size_t col) const { return cols[col].name; }
+  ColumnType getColType(size_t col) const { return cols[col].type; }
+
+  uint32_t getRowId(size_t row) const { return rows[row]; } // Table row
+  const std::vector<uint32_t> &getRowIds() const { return rows; }
+  const std::vector<SnailPlanStep> &getPlan() const { return plan; }
+
+  // INT/INT64/BOOL columns (FLOAT/DOUBLE truncated)
+  int64_t getInt64(size_t row, size_t col) const;
+  int getInt(size_t row, size_t col) const { return (int)getInt64(row, col); }
+  bool getBool(size_t row, size_t col) const { return getInt64(row, col) != 0; }
+  // Any numeric column
+  double getDouble(size_t row, size_t col) const;
+  // STR columns; empty string for other types
+  const std::string &getStr(size_t row, size_t col) const;
+
+private:
+  struct Col {
+    std::string name;
+    ColumnType type;
+    std::vector<int64_t> ints;    // INT, INT64, BOOL
+    std::vector<double> reals;    // FLOAT, DOUBLE
+    std::vector<uint16_t> tokens; // STR
+    const std::vector<std::string> *dict; // STR: the column's dictionary
+  };
+
+  std::vector<uint32_t> rows;
+  std::vector<Col> cols;
+  std::vector<SnailPlanStep> plan;
+};
+
+// =========================================================
+// Query Pipeline (v1.1)
+// =========================================================
+//
+// Conjunctive (AND) queries over one table:
+//
+//   SnailQuery q(db);
+//   q.where("sensor", OP_EQ, "Temp").where("value", OP_GT, "50")
+//    .whereTime(t0, t1).select("sensor").select("value");
+//   SnailQueryResult r;
+//   q.run(r);
+//
+// Values are strings, parsed once per run like findRow(). Each predicate gets
+// an access path: sorted columns and sorted timestamps become row spans that
+// are intersected first; an equality on an indexed column can seed the
+// selection; everything else is scanned. The most selective predicate builds
+// the selection vector, and each later one only tests the rows still in it.
+class SnailQuery {
+public:
+  explicit SnailQuery(const SnailDB &db) : db(db) {}
+
+  SnailQuery &where(const std::string &colName, SnailOp op, const std::string &value);
+  SnailQuery &whereBetween(const std::string &colName, const std::string &lo,
+                           const std::string &hi);
+  SnailQuery &whereTime(uint32_t from, uint32_t to); // Inclusive
+  SnailQuery &select(const std::string &colName);    // None selected: all columns
+
+  // Returns false (and an empty result) if a column is missing or the
+  // operator does not apply to its type.
+  bool run(SnailQueryResult &out) const;
+
+private:
+  struct Predicate {
+    std::string colName; // Empty: timestamp range
+    SnailOp op;
+    std::string value;
+    std::string value2; // OP_BETWEEN upper bound
+    uint32_t tsFrom, tsTo;
+  };
+  struct Compiled;
+  struct SpanSelect;
+  struct Refine;
+
+  bool compile(const Predicate &pred, Compiled &c) const;
+  void plan(Compiled &c) const;
+  template <typename Action> void dispatch(const Compiled &c, Action &act) const;
+  void materialize(SnailQueryResult &out) const;
+
+  const SnailDB &db;
+  std::vector<Predicate> preds;
+  std::vector<std::string> projection;
+};
+
+// =========================================================
+// Ordered Views / Top-K (v1.1)
+// =========================================================
+//
+// A permutation of row ids sorted by one column. Column data is never moved.
+// With a limit, only the best 'limit' rows are kept, using a bounded heap
+// (O(n log k)). STR columns sort by lexical rank of the dictionary entries.
+// Ties keep row order. NaN keys sort last in either direction. Tombstoned
+// rows are skipped when the view is built.
+// The view does not follow later inserts or deletes until orderBy() runs
+// again, and a purge() invalidates it.
+//
+//   SnailOrder top(db);
+//   top.orderBy("temp", false, 10); // 10 highest readings
+//   for (top.reset(); top.valid(); top.next()) {
+//     float t = top.get<float>(1);
+//   }
+class SnailOrder {
+public:
+  explicit SnailOrder(const SnailDB &db) : db(db), cursor(0) {}
+
+  // limit 0: every row. Returns false if the column is missing.
+  bool orderBy(const std::string &colName, bool ascending = true, size_t limit = 0);
+  // Orders a subset, e.g. SnailQueryResult::getRowIds()
+  bool orderBy(const std::string &colName, const std::vector<uint32_t> &rows,
+               bool ascending = true, size_t limit = 0);
+
+  size_t size() const { return perm.size(); }
+  uint32_t getRowId(size_t pos) const { return perm[pos]; }
+  const std::vector<uint32_t> &getRowIds() const { return perm; }
+
+  // Navigation in sort order; stepping past the last row makes valid() false
+  void reset() { cursor = 0; }
+  void next() { cursor++; }
+  void previous() { if (cursor > 0) cursor--; }
+  void tail() { cursor = perm.empty() ? 0 : perm.size() - 1; }
+  bool valid() const { return cursor < perm.size(); }
+  size_t getCursor() const { return cursor; }
+
+  // Typed access to the row under the cursor
+  template <typename T> T get(size_t colIndex) const;
+
+private:
+  template <typename KeyFn>
+  void build(KeyFn key, const std::vector<uint32_t> *rows, bool ascending, size_t limit);
+  bool buildFor(const std::string &colName, const std::vector<uint32_t> *rows,
+                bool ascending, size_t limit);
+  const Column *column(size_t colIndex) const {
+    if (!valid() || colIndex >= db.columns.size()) return nullptr;
+    return db.columns[colIndex].get();
+  }
+
+  const SnailDB &db;
+  std::vector<uint32_t> perm;
+  size_t cursor;
+};
+
+template <> inline int SnailOrder::get<int>(size_t colIndex) const {
+  const Column *col = column(colIndex);
+  return col ? col->getInt(perm[cursor]) : 0;
+}
+
+template <> inline std::string SnailOrder::get<std::string>(size_t colIndex) const {
+  const Column *col = column(colIndex);
+  return col ? col->getStr(perm[cursor]) : "";
+}
+
+template <> inline int64_t SnailOrder::get<int64_t>(size_t colIndex) const {
+  const Column *col = column(colIndex);
+  return col ? col->getInt64(perm[cursor]) : 0;
+}
+
+template <> inline float SnailOrder::get<float>(size_t colIndex) const {
+  const Column *col = column(colIndex);
+  return col ? col->getFloat(perm[cursor]) : 0.0f;
+}
+
+template <> inline double SnailOrder::get<double>(size_t colIndex) const {
+  const Column *col = column(colIndex);
+  return col ? col->getDouble(perm[cursor]) : 0.0;
+}
+
+template <> inline bool SnailOrder::get<bool>(size_t colIndex) const {
+  const Column *col = column(colIndex);
+  return col ? col->getBool(perm[cursor]) : false;
+}
+
+// =========================================================
+// Hash Join (v1.1)
+// =========================================================
+//
+// Inner equi-join of two tables on an INT/INT64 key or on two STR keys.
+// A hash table is built on the side with fewer active rows. The other side
+// is probed in batches: keys are hashed for the whole batch first, then
+// the chains are walked. For two STR columns there is no hashing. Each
+// probe-side dictionary entry is mapped once to the build side's token,
+// and build rows are chained per token.
+//
+//   SnailJoin join(readings, "device", devices, "device");
+//   SnailJoinResult pairs;
+//   join.run(pairs); // pairs.left[i] matches pairs.right[i]
+
+// Matching row ids, pairwise, in probe-side row order
+struct SnailJoinResult {
+  std::vector<uint32_t> left;
+  std::vector<uint32_t> right;
+
+  size_t size() const { return left.size(); }
+};
+
+class SnailJoin {
+public:
+  SnailJoin(const SnailDB &left, const std::string &leftCol, const SnailDB &right,
+            const std::string &rightCol)
+      : left(left), right(right), leftCol(leftCol), rightCol(rightCol) {}
+
+  // Returns false if a key column is missing or the key types differ
+  // (INT and INT64 join with each other; FLOAT/DOUBLE/BOOL keys are not
+  // supported).
+  bool run(SnailJoinResult &out) const;
+
+  // Copies the listed columns of the joined rows into 'out', which must have
+  // no columns yet. Left columns come first. Timestamps are taken from the
+  // left rows. Returns false on a missing or duplicate column name.
+  bool materialize(const SnailJoinResult &rows, const std::vector<std::string> &leftCols,
+                   const std::vector<std::string> &rightCols, SnailDB &out) const;
+
+private:
+  static const size_t PROBE_BATCH = 256;
+
+  template <typename BuildKey, typename ProbeKey>
+  void intJoin(const SnailDB &build, BuildKey buildKey, const SnailDB &probe, ProbeKey probeKey,
+               std::vector<uint32_t> &buildOut, std::vector<uint32_t> &probeOut) const;
+  void strJoin(const SnailDB &build, const InternalStrColumn &buildCol, const SnailDB &probe,
+               const InternalStrColumn &probeCol, std::vector<uint32_t> &buildOut,
+               std::vector<uint32_t> &probeOut) const;
+
+  const SnailDB &left;
+  const SnailDB &right;
+  std::string leftCol;
+  std::string rightCol;
+};
+
+#endif // SNAIL_QUERY_H
@@ -2,73 +2,235 @@
 #define SNAIL_STORAGE_H
 
 #include "snaildb.h"
+#include <algorithm>
 #include <cstring>
 #include <fstream>
 #include <string>
 #include <vector>
 
+// Typed tables (snail_table.h) share the .snail layout
+template <typename Name> class IntCol;
+template <typename Name, size_t MaxLen> class StrCol;
+template <typename Name, typename T, ColumnType TYPE> class NumCol;
+template <typename Name> class BoolCol;
+template <typename... Cols> class SnailTable;
+
 class SnailStorage {
 public:
   static bool save(const SnailDB &db, const std::string &filename) {
+    SnailStatScope stats(STAT_SAVE);
     std::ofstream file(filename, std::ios::binary);
     if (!file.is_open()) return false;
 
-    // 1. Magic Header
-    file.write("SNAL", 4);
-
-    // 2. Size Info
-    uint32_t numRows = (uint32_t)db.numRows;
-    uint32_t numCols = (uint32_t)db.colInfos.size();
-    file.write((const char *)&numRows, sizeof(numRows));
-    file.write((const char *)&numCols, sizeof(numCols));
+    // 1. Magic Header + 2. Size Info
+    writeHeader(file, (uint32_t)db.numRows, (uint32_t)db.colInfos.size());
 
     // 3. Schema
     for (const auto &info : db.colInfos) {
-      uint8_t type = (uint8_t)info.type;
-      uint16_t maxLen = (uint16_t)info.max_length;
-      uint8_t nameLen = (uint8_t)info.name.length();
-      file.write((const char *)&type, sizeof(type));
-      file.write((const char *)&maxLen, sizeof(maxLen));
-      file.write((const char *)&nameLen, sizeof(nameLen));
-      file.write(info.name.c_str(), nameLen);
+      writeSchemaEntry(file, info.type, info.max_length, info.name, info.orderedDict);
     }
 
     // 4. Data Blocks
-    for (uint32_t i = 0; i < numCols; ++i) {
+    for (size_t i = 0; i < db.columns.size(); ++i) {
       Column *col = db.columns[i].get();
-      
-      if (col->getType() == INT_TYPE) {
-        InternalIntColumn* intCol = static_cast<InternalIntColumn*>(col);
-        size_t byteSize = intCol->storage.size() * sizeof(int);
-        if (byteSize > 0) {
-            file.write((const char *)intCol->storage.data(), byteSize);
-        }
-      } else {
-        InternalStrColumn* strCol = static_cast<InternalStrColumn*>(col);
-        
-        // Save Dictionary
-        uint16_t dictSize = (uint16_t)strCol->dictionary.size();
-        file.write((const char*)&dictSize, sizeof(dictSize));
-        
-        for(const auto& s : strCol->dictionary) {
-            uint16_t sLen = (uint16_t)s.length();
-            file.write((const char*)&sLen, sizeof(sLen));
-            file.write(s.c_str(), sLen);
-        }
 
-        // Save Tokens
-        size_t dataSize = strCol->data.size() * sizeof(uint16_t);
-        if (dataSize > 0) {
-            file.write((const char *)strCol->data.data(), dataSize);
-        }
+      switch (col->getType()) {
+      case INT_TYPE:
+        writeRawBlock(file, static_cast<InternalIntColumn *>(col)->storage);
+        break;
+      case INT64_TYPE:
+        writeRawBlock(file, static_cast<InternalInt64Column *>(col)->storage);
+        break;
+      case FLOAT_TYPE:
+        writeRawBlock(file, static_cast<InternalFloatColumn *>(col)->storage);
+        break;
+      case DOUBLE_TYPE:
+        writeRawBlock(file, static_cast<InternalDoubleColumn *>(col)->storage);
+        break;
+      case BOOL_TYPE:
+        // Packed bits: ceil(numRows / 8) bytes
+        writeRawBlock(file, static_cast<InternalBoolColumn *>(col)->bits);
+        break;
+      case STR_TYPE: {
+        InternalStrColumn* strCol = static_cast<InternalStrColumn*>(col);
+        writeStrBlock(file, strCol->dictionary, strCol->data);
+        break;
+      }
       }
     }
 
     // 5. System Vectors (Fixed for v1.0)
+    writeSystemBlock(file, db.activeRows, db.timestamps);
+    return true;
+  }
+
+  static bool load(SnailDB &db, const std::string &filename) {
+    SnailStatScope stats(STAT_LOAD);
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) return false;
+
+    uint32_t numRows, numCols;
+    if (!readHeader(file, numRows, numCols)) return false;
+
+    // 3. Read Schema: the table is only touched once every entry is known
+    std::vector<ColumnInfo> schema(numCols);
+    for (uint32_t i = 0; i < numCols; ++i) {
+      readSchemaEntry(file, schema[i]);
+      if (!file || schema[i].type > BOOL_TYPE) return false; // Newer version
+    }
+
+    // Rebuild Schema (Clear existing)
+    // In a real app, you might want to verify schema match instead of rebuilding
+    // For this demo, we assume we are loading into an empty DB or overwriting
+    db.columns.clear();
+    db.colNames.clear();
+    db.colInfos.clear();
+    db.cursor = 0;
+    db.schemaEpoch++;
+    for (const ColumnInfo &info : schema) {
+      db.addColProp(info.name, info.max_length, info.type, info.orderedDict);
+    }
+
+    db.numRows = numRows;
+
+    // 4. Load Data
+    for (uint32_t i = 0; i < numCols; ++i) {
+      Column *col = db.columns[i].get();
+
+      switch (col->getType()) {
+      case INT_TYPE: {
+        InternalIntColumn *intCol = static_cast<InternalIntColumn *>(col);
+        readRawBlock(file, intCol->storage, numRows);
+        intCol->sorted = isAscending(intCol->storage);
+        break;
+      }
+      case INT64_TYPE:
+        readNumBlock(file, *static_cast<InternalInt64Column *>(col), numRows);
+        break;
+      case FLOAT_TYPE:
+        readNumBlock(file, *static_cast<InternalFloatColumn *>(col), numRows);
+        break;
+      case DOUBLE_TYPE:
+        readNumBlock(file, *static_cast<InternalDoubleColumn *>(col), numRows);
+        break;
+      case BOOL_TYPE: {
+        InternalBoolColumn *boolCol = static_cast<InternalBoolColumn *>(col);
+        readRawBlock(file, boolCol->bits, (numRows + 7) / 8);
+        boolCol->count = numRows;
+        break;
+      }
+      case STR_TYPE: {
+        InternalStrColumn *strCol = static_cast<InternalStrColumn *>(col);
+        readStrBlock(file, strCol->dictionary, strCol->data, numRows);
+        strCol->sorted = std::is_sorted(strCol->data.begin(), strCol->data.end());
+        strCol->dictSorted =
+            std::is_sorted(strCol->dictionary.begin(), strCol->dictionary.end());
+        break;
+      }
+      }
+    }
+
+    // 5. Load System Vectors
+    readSystemBlock(file, db.activeRows, db.timestamps, numRows);
+    db.tsSorted = std::is_sorted(db.timestamps.begin(), db.timestamps.end());
+    return true;
+  }
+
+  // Typed tables (v1.1): same file layout as SnailDB
+  template <typename... Cols>
+  static bool save(const SnailTable<Cols...> &table, const std::string &filename) {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) return false;
+
+    writeHeader(file, (uint32_t)table.numRows, (uint32_t)sizeof...(Cols));
+    SchemaWriter schema = {file};
+    table.forEachColumn(schema);
+    BlockWriter blocks = {file};
+    table.forEachColumn(blocks);
+    writeSystemBlock(file, table.activeRows, table.timestamps);
+    return true;
+  }
+
+  // Unlike the SnailDB overload, the schema is fixed at compile time: the
+  // file is rejected unless its column names and types match exactly.
+  template <typename... Cols>
+  static bool load(SnailTable<Cols...> &table, const std::string &filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) return false;
+
+    uint32_t numRows, numCols;
+    if (!readHeader(file, numRows, numCols)) return false;
+    if (numCols != sizeof...(Cols)) return false;
+
+    SchemaChecker schema = {file, true};
+    table.forEachColumn(schema);
+    if (!schema.ok) return false;
+
+    BlockReader blocks = {file, numRows};
+    table.forEachColumn(blocks);
+    readSystemBlock(file, table.activeRows, table.timestamps, numRows);
+    table.numRows = numRows;
+    return true;
+  }
+
+private:
+  // --- Block Writers ---
+
+  static void writeHeader(std::ofstream &file, uint32_t numRows, uint32_t numCols) {
+    file.write("SNAL", 4);
+    file.write((const char *)&numRows, sizeof(numRows));
+    file.write((const char *)&numCols, sizeof(numCols));
+  }
+
+  static void writeSchemaEntry(std::ofstream &file, ColumnType colType,
+                               size_t maxLength, const std::string &name,
+                               bool orderedDict = false) {
+    uint8_t type = (uint8_t)colType;
+    if (orderedDict) type |= COL_FLAG_ORDERED_DICT;
+    uint16_t maxLen = (uint16_t)maxLength;
+    uint8_t nameLen = (uint8_t)name.length();
+    file.write((const char *)&type, sizeof(type));
+    file.write((const char *)&maxLen, sizeof(maxLen));
+    file.write((const char *)&nameLen, sizeof(nameLen));
+    file.write(name.c_str(), nameLen);
+  }
+
+  // Fixed-width columns are dumped as-is (native byte order)
+  template <typename T>
+  static void writeRawBlock(std::ofstream &file, const std::vector<T> &storage) {
+    size_t byteSize = storage.size() * sizeof(T);
+    if (byteSize > 0) {
+        file.write((const char *)storage.data(), byteSize);
+    }
+  }
+
+  static void writeStrBlock(std::ofstream &file,
+                            const std::vector<std::string> &dictionary,
+                            const std::vector<uint16_t> &tokens) {
+    // Save Dictionary
+    uint16_t dictSize = (uint16_t)dictionary.size();
+    file.write((const char*)&dictSize, sizeof(dictSize));
+
+    for(const auto& s : dictionary) {
+        uint16_t sLen = (uint16_t)s.length();
+        file.write((const char*)&sLen, sizeof(sLen));
+        file.write(s.c_str(), sLen);
+    }
+
+    // Save Tokens
+    size_t dataSize = tokens.size() * sizeof(uint16_t);
+    if (dataSize > 0) {
+        file.write((const char *)tokens.data(), dataSize);
+    }
+  }
+
+  static void writeSystemBlock(std::ofstream &file,
+                               const std::vector<bool> &activeRows,
+                               const std::vector<uint32_t> &timestamps) {
     // Convert bool vector to byte vector for safe writing
     std::vector<uint8_t> activeBytes;
-    activeBytes.reserve(db.numRows);
-    for (bool b : db.activeRows) {
+    activeBytes.reserve(activeRows.size());
+    for (bool b : activeRows) {
         activeBytes.push_back(b ? 1 : 0);
     }
     if (!activeBytes.empty()) {
@@ -76,104 +238,174 @@ public:
     }
 
     // Save Timestamps
-    if (!db.timestamps.empty()) {
-        file.write((const char *)db.timestamps.data(), db.timestamps.size() * sizeof(uint32_t));
+    if (!timestamps.empty()) {
+        file.write((const char *)timestamps.data(), timestamps.size() * sizeof(uint32_t));
     }
-
-    return true;
   }
 
-  static bool load(SnailDB &db, const std::string &filename) {
-    std::ifstream file(filename, std::ios::binary);
-    if (!file.is_open()) return false;
+  // --- Block Readers ---
 
+  static bool readHeader(std::ifstream &file, uint32_t &numRows, uint32_t &numCols) {
     char magic[4];
     file.read(magic, 4);
-    if (strncmp(magic, "SNAL", 4) != 0) return false;
+    if (!file || strncmp(magic, "SNAL", 4) != 0) return false;
 
-    uint32_t numRows, numCols;
     file.read((char *)&numRows, sizeof(numRows));
     file.read((char *)&numCols, sizeof(numCols));
+    return (bool)file;
+  }
 
-    // Rebuild Schema (Clear existing)
-    // In a real app, you might want to verify schema match instead of rebuilding
-    // For this demo, we assume we are loading into an empty DB or overwriting
-    
-    // 3. Read Schema
-    for (uint32_t i = 0; i < numCols; ++i) {
-      uint8_t type;
-      uint16_t maxLen;
-      uint8_t nameLen;
+  static void readSchemaEntry(std::ifstream &file, ColumnInfo &info) {
+    uint8_t type;
+    uint16_t maxLen;
+    uint8_t nameLen;
 
-      file.read((char *)&type, sizeof(type));
-      file.read((char *)&maxLen, sizeof(maxLen));
-      file.read((char *)&nameLen, sizeof(nameLen));
+    file.read((char *)&type, sizeof(type));
+    file.read((char *)&maxLen, sizeof(maxLen));
+    file.read((char *)&nameLen, sizeof(nameLen));
 
-      std::string name(nameLen, '\0');
-      file.read(&name[0], nameLen);
+    info.name.assign(nameLen, '\0');
+    file.read(&info.name[0], nameLen);
+    info.max_length = maxLen;
+    info.type = (ColumnType)(type & COL_TYPE_MASK);
+    info.orderedDict = (type & COL_FLAG_ORDERED_DICT) != 0;
+  }
 
-      if (type == (uint8_t)INT_TYPE) {
-        db.addIntColProp(name, maxLen);
-      } else {
-        db.addStrColProp(name, maxLen);
-      }
-    }
+  template <typename T>
+  static void readRawBlock(std::ifstream &file, std::vector<T> &storage,
+                           uint32_t count) {
+    storage.resize(count);
+    size_t byteSize = count * sizeof(T);
+    if (byteSize > 0) file.read((char *)storage.data(), byteSize);
+  }
 
-    db.numRows = numRows;
-    db.activeRows.clear();
-    db.timestamps.clear();
+  template <typename T, ColumnType TYPE>
+  static void readNumBlock(std::ifstream &file, InternalNumColumn<T, TYPE> &col,
+                           uint32_t numRows) {
+    readRawBlock(file, col.storage, numRows);
+    col.sorted = isAscending(col.storage);
+  }
 
-    // 4. Load Data
-    for (uint32_t i = 0; i < numCols; ++i) {
-      Column *col = db.columns[i].get();
+  // std::is_sorted treats a NaN as ordered against everything
+  template <typename T> static bool isAscending(const std::vector<T> &vals) {
+    for (size_t i = 1; i < vals.size(); ++i) {
+      if (!(vals[i] >= vals[i - 1])) return false;
+    }
+    return true;
+  }
 
-      if (col->getType() == INT_TYPE) {
-        size_t byteSize = numRows * sizeof(int);
-        col->resizeStorage(byteSize);
-        if (byteSize > 0) file.read(col->getWritableBuffer(), byteSize);
-      } else {
-        InternalStrColumn *strCol = static_cast<InternalStrColumn *>(col);
-        
-        // Load Dictionary
-        uint16_t dictSize = 0;
-        file.read((char *)&dictSize, sizeof(dictSize));
-        strCol->dictionary.resize(dictSize);
-        
-        for (int k = 0; k < dictSize; ++k) {
-          uint16_t strLen = 0;
-          file.read((char *)&strLen, sizeof(strLen));
-          std::string s(strLen, '\0');
-          file.read(&s[0], strLen);
-          strCol->dictionary[k] = s;
-        }
+  static void readStrBlock(std::ifstream &file,
+                           std::vector<std::string> &dictionary,
+                           std::vector<uint16_t> &tokens, uint32_t numRows) {
+    // Load Dictionary
+    uint16_t dictSize = 0;
+    file.read((char *)&dictSize, sizeof(dictSize));
+    dictionary.resize(dictSize);
 
-        // Load Tokens
-        size_t byteSize = numRows * sizeof(uint16_t);
-        col->resizeStorage(byteSize);
-        if (byteSize > 0) file.read(col->getWritableBuffer(), byteSize);
-      }
+    for (int k = 0; k < dictSize; ++k) {
+      uint16_t strLen = 0;
+      file.read((char *)&strLen, sizeof(strLen));
+      std::string s(strLen, '\0');
+      file.read(&s[0], strLen);
+      dictionary[k] = s;
     }
 
-    // 5. Load System Vectors
+    // Load Tokens
+    tokens.resize(numRows);
+    size_t byteSize = numRows * sizeof(uint16_t);
+    if (byteSize > 0) file.read((char *)tokens.data(), byteSize);
+  }
+
+  static void readSystemBlock(std::ifstream &file, std::vector<bool> &activeRows,
+                              std::vector<uint32_t> &timestamps, uint32_t numRows) {
+    activeRows.clear();
+    timestamps.clear();
+
     if (file.peek() != EOF) {
         std::vector<uint8_t> activeBytes(numRows);
         file.read((char *)activeBytes.data(), numRows);
-        
-        db.activeRows.reserve(numRows);
+
+        activeRows.reserve(numRows);
         for(uint8_t b : activeBytes) {
-            db.activeRows.push_back(b != 0);
+            activeRows.push_back(b != 0);
         }
 
-        db.timestamps.resize(numRows);
-        file.read((char *)db.timestamps.data(), numRows * sizeof(uint32_t));
+        timestamps.resize(numRows);
+        file.read((char *)timestamps.data(), numRows * sizeof(uint32_t));
     } else {
         // Fallback for old files
-        db.activeRows.assign(numRows, true);
-        db.timestamps.assign(numRows, 0);
+        activeRows.assign(numRows, true);
+        timestamps.assign(numRows, 0);
     }
+  }
 
-    return true;
+  // --- Typed Table Visitors ---
+
+  template <typename Name>
+  static void writeBlock(std::ofstream &file, const IntCol<Name> &col) {
+    writeRawBlock(file, col.storage);
+  }
+  template <typename Name, size_t MaxLen>
+  static void writeBlock(std::ofstream &file, const StrCol<Name, MaxLen> &col) {
+    writeStrBlock(file, col.dictionary, col.data);
+  }
+  template <typename Name, typename T, ColumnType TYPE>
+  static void writeBlock(std::ofstream &file, const NumCol<Name, T, TYPE> &col) {
+    writeRawBlock(file, col.storage);
+  }
+  template <typename Name>
+  static void writeBlock(std::ofstream &file, const BoolCol<Name> &col) {
+    writeRawBlock(file, col.bits);
+  }
+  template <typename Name, typename T, ColumnType TYPE>
+  static void readBlock(std::ifstream &file, NumCol<Name, T, TYPE> &col,
+                        uint32_t numRows) {
+    readRawBlock(file, col.storage, numRows);
+    col.sorted = isAscending(col.storage);
+  }
+  template <typename Name>
+  static void readBlock(std::ifstream &file, BoolCol<Name> &col, uint32_t numRows) {
+    readRawBlock(file, col.bits, (numRows + 7) / 8);
+    col.count = numRows;
+  }
+  template <typename Name>
+  static void readBlock(std::ifstream &file, IntCol<Name> &col, uint32_t numRows) {
+    readRawBlock(file, col.storage, numRows);
+    col.sorted = std::is_sorted(col.storage.begin(), col.storage.end());
   }
+  template <typename Name, size_t MaxLen>
+  static void readBlock(std::ifstream &file, StrCol<Name, MaxLen> &col,
+                        uint32_t numRows) {
+    readStrBlock(file, col.dictionary, col.data, numRows);
+  }
+
+  struct SchemaWriter {
+    std::ofstream &file;
+    template <typename C> void operator()(const C &) {
+      writeSchemaEntry(file, C::type, C::maxLength(), C::name());
+    }
+  };
+
+  struct SchemaChecker {
+    std::ifstream &file;
+    bool ok;
+    template <typename C> void operator()(const C &) {
+      ColumnInfo info;
+      readSchemaEntry(file, info);
+      if (info.type != C::type || info.name != C::name()) ok = false;
+    }
+  };
+
+  struct BlockWriter {
+    std::ofstream &file;
+    template <typename C> void operator()(const C &col) { writeBlock(file, col); }
+  };
+
+  struct BlockReader {
+    std::ifstream &file;
+    uint32_t numRows;
+    template <typename C> void operator()(C &col) { readBlock(file, col, numRows); }
+  };
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,422 @@
+// snail_table.h
+#ifndef SNAIL_TABLE_H
+#define SNAIL_TABLE_H
+
+#include "snaildb.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// =========================================================
+// Compile-Time Typed Table (v1.1)
+// =========================================================
+//
+// SnailTable resolves its schema at compile time: columns are concrete
+// members (no Column vtable), every accessor is inline, and insert() with the
+// wrong arity or value types fails to compile instead of being dropped.
+//
+//   SNAIL_COLUMN_NAME(Id, "id");
+//   SNAIL_COLUMN_NAME(Sensor, "sensor");
+//
+//   SnailTable<IntCol<Id>, StrCol<Sensor, 10>> table;
+//   table.insertAt(1000, 1, "Temp_Sensor_1");
+//   int id = table.get<0>(0);
+//
+// Files written by SnailStorage::save(table, ...) use the regular .snail
+// layout and can be loaded into a SnailDB, and vice versa.
+
+// C++11 cannot take string literals as template arguments, so column names
+// are carried by small tag types.
+#define SNAIL_COLUMN_NAME(Tag, str)                                            \
+  struct Tag {                                                                 \
+    static const char *name() { return str; }                                  \
+  }
+
+template <typename Name> class IntCol {
+  friend class SnailStorage;
+
+public:
+  typedef int value_type;
+  static const ColumnType type = INT_TYPE;
+  static const char *name() { return Name::name(); }
+  static size_t maxLength() { return 0; }
+
+  // Only integers that convert to int without narrowing: int64_t, uint32_t
+  // or size_t values need an INT64 column (or an explicit cast)
+  template <typename T> struct accepts {
+    static const bool value =
+        std::is_integral<T>::value && !std::is_same<T, bool>::value &&
+        (std::is_signed<T>::value ? sizeof(T) <= sizeof(int) : sizeof(T) < sizeof(int));
+  };
+
+  size_t size() const { return storage.size(); }
+  void reserve(size_t n) { storage.reserve(n); }
+  bool isSorted() const { return sorted; }
+
+  void add(int val) {
+    if (sorted && !storage.empty() && val < storage.back())
+      sorted = false;
+    storage.push_back(val);
+  }
+
+  int get(size_t index) const { return storage[index]; }
+
+  int find(int val) const {
+    if (sorted) {
+      auto it = std::lower_bound(storage.begin(), storage.end(), val);
+      if (it != storage.end() && *it == val)
+        return (int)(it - storage.begin());
+      return -1;
+    }
+    for (size_t i = 0; i < storage.size(); ++i) {
+      if (storage[i] == val) return (int)i;
+    }
+    return -1;
+  }
+
+  void compact(const std::vector<bool> &keepMask) {
+    size_t dst = 0;
+    for (size_t i = 0; i < storage.size(); ++i) {
+      if (keepMask[i]) storage[dst++] = storage[i];
+    }
+    storage.resize(dst);
+    // Removing rows cannot unsort the column, so 'sorted' is kept
+  }
+
+private:
+  std::vector<int> storage;
+  bool sorted = true;
+};
+
+// Native numeric columns: Int64Col, FloatCol, DoubleCol
+template <typename Name, typename T, ColumnType TYPE> class NumCol {
+  friend class SnailStorage;
+
+public:
+  typedef T value_type;
+  static const ColumnType type = TYPE;
+  static const char *name() { return Name::name(); }
+  static size_t maxLength() { return 0; }
+
+  // Only values T holds exactly, as for IntCol: no double into an Int64Col,
+  // no int64_t or double into a FloatCol (cast explicitly instead)
+  template <typename V> struct accepts {
+    static const bool value =
+        std::is_arithmetic<V>::value && !std::is_same<V, bool>::value &&
+        (std::is_floating_point<T>::value || !std::is_floating_point<V>::value) &&
+        (std::is_signed<T>::value || !std::is_signed<V>::value) &&
+        std::numeric_limits<V>::digits <= std::numeric_limits<T>::digits;
+  };
+
+  size_t size() const { return storage.size(); }
+  void reserve(size_t n) { storage.reserve(n); }
+  bool isSorted() const { return sorted; }
+
+  void add(T val) {
+    if (sorted && !storage.empty() && !(val >= storage.back())) // NaN: unsorted
+      sorted = false;
+    storage.push_back(val);
+  }
+
+  T get(size_t index) const { return storage[index]; }
+
+  int find(T val) const {
+    if (sorted) {
+      auto it = std::lower_bound(storage.begin(), storage.end(), val);
+      if (it != storage.end() && *it == val)
+        return (int)(it - storage.begin());
+      return -1;
+    }
+    for (size_t i = 0; i < storage.size(); ++i) {
+      if (storage[i] == val) return (int)i;
+    }
+    return -1;
+  }
+
+  void compact(const std::vector<bool> &keepMask) {
+    size_t dst = 0;
+    for (size_t i = 0; i < storage.size(); ++i) {
+      if (keepMask[i]) storage[dst++] = storage[i];
+    }
+    storage.resize(dst);
+  }
+
+private:
+  std::vector<T> storage;
+  bool sorted = true;
+};
+
+template <typename Name> using Int64Col = NumCol<Name, int64_t, INT64_TYPE>;
+template <typename Name> using FloatCol = NumCol<Name, float, FLOAT_TYPE>;
+template <typename Name> using DoubleCol = NumCol<Name, double, DOUBLE_TYPE>;
+
+// Bit-packed, same layout as InternalBoolColumn
+template <typename Name> class BoolCol {
+  friend class SnailStorage;
+
+public:
+  typedef bool value_type;
+  static const ColumnType type = BOOL_TYPE;
+  static const char *name() { return Name::name(); }
+  static size_t maxLength() { return 0; }
+
+  template <typename V> struct accepts {
+    static const bool value = std::is_same<V, bool>::value;
+  };
+
+  size_t size() const { return count; }
+  void reserve(size_t n) { bits.reserve((n + 7) / 8); }
+
+  void add(bool val) {
+    if ((count & 7) == 0) bits.push_back(0);
+    if (val) bits.back() |= (uint8_t)(1u << (count & 7));
+    count++;
+  }
+
+  bool get(size_t index) const { return (bits[index >> 3] >> (index & 7)) & 1u; }
+
+  int find(bool val) const {
+    for (size_t i = 0; i < count; ++i) {
+      if (get(i) == val) return (int)i;
+    }
+    return -1;
+  }
+
+  void compact(const std::vector<bool> &keepMask) {
+    size_t dst = 0;
+    for (size_t i = 0; i < count; ++i) {
+      if (!keepMask[i]) continue;
+      uint8_t mask = (uint8_t)(1u << (dst & 7));
+      if (get(i)) bits[dst >> 3] |= mask;
+      else bits[dst >> 3] &= (uint8_t)~mask;
+      dst++;
+    }
+    count = dst;
+    bits.resize((count + 7) / 8);
+    if (count & 7) bits.back() &= (uint8_t)((1u << (count & 7)) - 1);
+  }
+
+private:
+  std::vector<uint8_t> bits;
+  size_t count = 0;
+};
+
+template <typename Name, size_t MaxLen = 0> class StrCol {
+  friend class SnailStorage;
+
+public:
+  typedef std::string value_type;
+  static const ColumnType type = STR_TYPE;
+  static const char *name() { return Name::name(); }
+  static size_t maxLength() { return MaxLen; }
+
+  template <typename T> struct accepts {
+    static const bool value = std::is_convertible<const T &, std::string>::value;
+  };
+
+  size_t size() const { return data.size(); }
+  void reserve(size_t n) { data.reserve(n); }
+
+  void add(const char *val) { add(val, val ? std::strlen(val) : 0); }
+  void add(const std::string &val) { add(val.data(), val.size()); }
+
+  // Returned by reference: the dictionary owns the string, no copy per read
+  const std::string &get(size_t index) const { return dictionary[data[index]]; }
+
+  int find(const std::string &pattern) const {
+    int token = tokenOf(pattern.data(), pattern.size());
+    if (token == -1) return -1;
+    for (size_t i = 0; i < data.size(); ++i) {
+      if (data[i] == token) return (int)i;
+    }
+    return -1;
+  }
+
+  void compact(const std::vector<bool> &keepMask) {
+    size_t dst = 0;
+    for (size_t i = 0; i < data.size(); ++i) {
+      if (keepMask[i]) data[dst++] = data[i];
+    }
+    data.resize(dst);
+  }
+
+private:
+  int tokenOf(const char *s, size_t len) const {
+    for (size_t i = 0; i < dictionary.size(); ++i) {
+      const std::string &d = dictionary[i];
+      if (d.size() == len && std::memcmp(d.data(), s, len) == 0) return (int)i;
+    }
+    return -1;
+  }
+
+  void add(const char *s, size_t len) {
+    // Consecutive repeats are the common case in telemetry streams
+    if (!data.empty()) {
+      const std::string &last = dictionary[data.back()];
+      if (last.size() == len && std::memcmp(last.data(), s, len) == 0) {
+        data.push_back(data.back());
+        return;
+      }
+    }
+    int token = tokenOf(s, len);
+    if (token == -1) {
+      if (dictionary.size() < 65535) {
+        dictionary.push_back(std::string(s, len));
+        token = (int)(dictionary.size() - 1);
+      } else {
+        token = 0; // Overflow fallback
+      }
+    }
+    data.push_back((uint16_t)token);
+  }
+
+  std::vector<std::string> dictionary;
+  std::vector<uint16_t> data;
+};
+
+template <typename... Cols> class SnailTable {
+  friend class SnailStorage;
+
+public:
+  typedef std::tuple<Cols...> ColumnTuple;
+  template <size_t I>
+  using ColumnAt = typename std::tuple_element<I, ColumnTuple>::type;
+
+  static size_t getColCount() { return sizeof...(Cols); }
+
+  SnailTable() : numRows(0) {}
+
+  void reserve(size_t rows) {
+    Reserver r = {rows};
+    forEachColumn(r);
+    activeRows.reserve(rows);
+    timestamps.reserve(rows);
+  }
+
+  // Insert
+  template <typename... Args> void insert(const Args &...args) {
+    insertAt(0, args...); // Default TS = 0
+  }
+
+  template <typename... Args> void insertAt(uint32_t ts, const Args &...args) {
+    static_assert(sizeof...(Args) == sizeof...(Cols),
+                  "SnailTable: value count does not match the schema");
+    insertImpl<0>(args...);
+    // System fields
+    activeRows.push_back(true);
+    timestamps.push_back(ts);
+    numRows++;
+  }
+
+  // Typed Access
+  template <size_t I> ColumnAt<I> &col() { return std::get<I>(columns); }
+  template <size_t I> const ColumnAt<I> &col() const {
+    return std::get<I>(columns);
+  }
+
+  template <size_t I>
+  auto get(size_t row) const
+      -> decltype(std::declval<const ColumnAt<I> &>().get(0)) {
+    return std::get<I>(columns).get(row);
+  }
+
+  // Search (returns -1 if missing or deleted)
+  template <size_t I, typename T> int findRow(const T &value) const {
+    int idx = std::get<I>(columns).find(value);
+    if (idx != -1 && !activeRows[idx]) return -1;
+    return idx;
+  }
+
+  // Lifecycle
+  void softDelete(size_t index) {
+    if (index < activeRows.size()) activeRows[index] = false;
+  }
+
+  void deleteOlderThan(uint32_t threshold) {
+    for (size_t i = 0; i < timestamps.size(); ++i) {
+      if (timestamps[i] < threshold) activeRows[i] = false;
+    }
+  }
+
+  void purge() {
+    if (activeRows.empty()) return;
+    Compactor c = {activeRows};
+    forEachColumn(c);
+
+    size_t dst = 0;
+    for (size_t i = 0; i < timestamps.size(); ++i) {
+      if (activeRows[i]) timestamps[dst++] = timestamps[i];
+    }
+    timestamps.resize(dst);
+    numRows = dst;
+    activeRows.assign(numRows, true);
+  }
+
+  bool isActive(size_t index) const {
+    return index < activeRows.size() && activeRows[index];
+  }
+  uint32_t getTimestamp(size_t index) const { return timestamps[index]; }
+  size_t rowCount() const { return numRows; } // Including soft-deleted rows
+
+  size_t getSize() const { // Returns ACTIVE count
+    size_t count = 0;
+    for (bool b : activeRows)
+      if (b) count++;
+    return count;
+  }
+
+  // Calls f(column) for every column, in schema order
+  template <typename F> void forEachColumn(F &f) { forEachImpl<0>(f); }
+  template <typename F> void forEachColumn(F &f) const { forEachImpl<0>(f); }
+
+private:
+  template <size_t I> void insertImpl() {} // Base case
+
+  template <size_t I, typename T, typename... Rest>
+  void insertImpl(const T &val, const Rest &...rest) {
+    static_assert(ColumnAt<I>::template accepts<T>::value,
+                  "SnailTable: value type does not match the column type");
+    std::get<I>(columns).add(val);
+    insertImpl<I + 1>(rest...);
+  }
+
+  template <size_t I, typename F>
+  typename std::enable_if<(I < sizeof...(Cols))>::type forEachImpl(F &f) {
+    f(std::get<I>(columns));
+    forEachImpl<I + 1>(f);
+  }
+  template <size_t I, typename F>
+  typename std::enable_if<(I == sizeof...(Cols))>::type forEachImpl(F &) {}
+
+  template <size_t I, typename F>
+  typename std::enable_if<(I < sizeof...(Cols))>::type
+  forEachImpl(F &f) const {
+    f(std::get<I>(columns));
+    forEachImpl<I + 1>(f);
+  }
+  template <size_t I, typename F>
+  typename std::enable_if<(I == sizeof...(Cols))>::type
+  forEachImpl(F &) const {}
+
+  struct Reserver {
+    size_t rows;
+    template <typename C> void operator()(C &col) { col.reserve(rows); }
+  };
+
+  struct Compactor {
+    const std::vector<bool> &keepMask;
+    template <typename C> void operator()(C &col) { col.compact(keepMask); }
+  };
+
+  ColumnTuple columns;
+
+  // System Vectors (same layout as SnailDB)
+  std::vector<bool> activeRows;
+  std::vector<uint32_t> timestamps;
+  size_t numRows;
+};
+
+#endif // SNAIL_TABLE_H
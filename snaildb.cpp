@@ -1,8 +1,14 @@
 #include "snaildb.h"
 #include <algorithm>
-#include <cstdlib> // std::atoi
+#include <cstdlib> // std::atoi, std::strtoll, std::strtod
 #include <cstring> // std::memcpy
 
+#ifdef ARDUINO
+#include <Arduino.h> // micros()
+#else
+#include <chrono>
+#endif
+
 // =========================================================
 // Hashing Helper (DJB2)
 // =========================================================
@@ -19,234 +25,933 @@ static uint32_t hashInt(int val) {
   return (uint32_t)val * 2654435761u;
 }
 
+// =========================================================
+// Memory Accounting & Instrumentation
+// =========================================================
+
+uint32_t snailMicros() {
+#ifdef ARDUINO
+  return (uint32_t)micros();
+#else
+  using namespace std::chrono;
+  return (uint32_t)duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+void SnailHistogram::record(uint32_t us) {
+  int b = 0;
+  while (b < BUCKETS - 1 && (us + 1) >> (b + 1)) b++;
+  buckets[b]++;
+  count++;
+  totalUs += us;
+  if (us > maxUs) maxUs = us;
+}
+
+SnailStats &SnailStats::instance() {
+  static SnailStats stats = SnailStats();
+  return stats;
+}
+
+bool SnailStats::enabled() { return SNAILDB_STATS != 0; }
+
+void SnailStats::reset() { *this = SnailStats(); }
+
+SnailStatScope::SnailStatScope(SnailStatOp op) : op(op), start(0) {
+#if SNAILDB_STATS
+  SnailStats &st = SnailStats::instance();
+  if (op == STAT_SAVE) st.saves++;
+  else st.loads++;
+  start = snailMicros();
+#endif
+}
+
+SnailStatScope::~SnailStatScope() {
+#if SNAILDB_STATS
+  SnailStats &st = SnailStats::instance();
+  (op == STAT_SAVE ? st.saveTime : st.loadTime).record(snailMicros() - start);
+#else
+  (void)op;
+  (void)start;
+#endif
+}
+
+template <typename T>
+static void addVectorBytes(SnailBytes &bytes, const std::vector<T> &v) {
+  bytes.used += v.size() * sizeof(T);
+  bytes.reserved += v.capacity() * sizeof(T);
+}
+
+static void addDictionaryBytes(SnailBytes &bytes, const std::vector<std::string> &dict) {
+  addVectorBytes(bytes, dict);
+  for (const std::string &s : dict) {
+    // Short strings live inside the std::string object itself (SSO)
+    const char *obj = reinterpret_cast<const char *>(&s);
+    bool inline_ = s.data() >= obj && s.data() < obj + sizeof(std::string);
+    if (!inline_) {
+      bytes.used += s.size() + 1;
+      bytes.reserved += s.capacity() + 1;
+    }
+  }
+}
+
+// =========================================================
+// SnailRowIndex
+// =========================================================
+
+void SnailRowIndex::build(std::vector<IndexEntry> &entries) {
+  // Entries arrive in row order: a stable LSD radix sort on the hash yields
+  // (hash, rowIdx) order in O(rows). Passes where every entry shares the
+  // digit are skipped (e.g. the high bytes of 16-bit string tokens).
+  size_t n = entries.size();
+  std::vector<IndexEntry> tmp;
+  for (int shift = 0; shift < 32; shift += 8) {
+    size_t offset[257] = {0};
+    for (const IndexEntry &e : entries) offset[((e.hash >> shift) & 0xFF) + 1]++;
+    if (n == 0 || offset[((entries[0].hash >> shift) & 0xFF) + 1] == n) continue;
+    for (int b = 0; b < 256; ++b) offset[b + 1] += offset[b];
+    tmp.resize(n);
+    for (const IndexEntry &e : entries) tmp[offset[(e.hash >> shift) & 0xFF]++] = e;
+    entries.swap(tmp);
+  }
+  main.swap(entries);
+  delta.clear();
+  enabled = true;
+}
+
+void SnailRowIndex::clear() {
+  main.clear();
+  delta.clear();
+  enabled = false;
+}
+
+size_t SnailRowIndex::deltaLimit() const {
+  // Power of two >= sqrt(main): merges cost O(main) every ~sqrt(main) inserts
+  size_t limit = 32;
+  while (limit * limit < main.size()) limit *= 2;
+  return limit;
+}
+
+void SnailRowIndex::merge() {
+  if (delta.empty()) return;
+  SNAIL_COUNT(indexMerges, 1);
+  std::sort(delta.begin(), delta.end());
+  size_t mid = main.size();
+  main.insert(main.end(), delta.begin(), delta.end());
+  std::inplace_merge(main.begin(), main.begin() + mid, main.end());
+  delta.clear();
+}
+
+void SnailRowIndex::compact(const std::vector<bool> &keepMask) {
+  if (!enabled) return;
+
+  // A kept row moves down by the number of removed rows before it
+  std::vector<uint32_t> newIdx(keepMask.size());
+  uint32_t next = 0;
+  for (size_t i = 0; i < keepMask.size(); ++i) {
+    newIdx[i] = next;
+    if (keepMask[i]) next++;
+  }
+
+  // Filtering keeps each run in its existing order
+  std::vector<IndexEntry> *runs[] = { &main, &delta };
+  for (std::vector<IndexEntry> *run : runs) {
+    size_t dst = 0;
+    for (size_t i = 0; i < run->size(); ++i) {
+      uint32_t row = (*run)[i].rowIdx;
+      if (row < keepMask.size() && keepMask[row]) {
+        (*run)[dst].hash = (*run)[i].hash;
+        (*run)[dst].rowIdx = newIdx[row];
+        dst++;
+      }
+    }
+    run->resize(dst);
+  }
+}
+
+void SnailRowIndex::addMemoryStats(SnailBytes &bytes) const {
+  addVectorBytes(bytes, main);
+  addVectorBytes(bytes, delta);
+}
+
 // =========================================================
 // Internal Column Implementations
 // =========================================================
 
 // --- InternalIntColumn ---
 
-class InternalIntColumn : public Column {
-public:
-  InternalIntColumn() {}
+InternalIntColumn::InternalIntColumn() {}
+
+ColumnType InternalIntColumn::getType() const { return INT_TYPE; }
+size_t InternalIntColumn::size() const { return storage.size(); }
+void InternalIntColumn::reserve(size_t n) { storage.reserve(n); }
+bool InternalIntColumn::isSorted() const { return sorted; }
+bool InternalIntColumn::isIndexed() const { return index.isEnabled(); }
+
+void InternalIntColumn::compact(const std::vector<bool> &keepMask) {
+  if (keepMask.size() != storage.size()) return;
+
+  // Two-Pointer In-Place Compaction
+  size_t dst = 0;
+  for (size_t i = 0; i < storage.size(); ++i) {
+      if (keepMask[i]) {
+          if (dst != i) {
+              storage[dst] = storage[i];
+          }
+          dst++;
+      }
+  }
+  storage.resize(dst);
+  // Removing rows from a sorted sequence leaves it sorted
+  index.compact(keepMask);
+}
+
+void InternalIntColumn::addInt(int val) {
+  if (sorted && !storage.empty()) {
+    if (val < storage.back())
+      sorted = false;
+  }
+  index.append(hashInt(val), (uint32_t)storage.size());
+  storage.push_back(val);
+}
+
+void InternalIntColumn::addInts(const int *vals, size_t n) {
+  if (n == 0) return;
+  // Sortedness is checked once over the batch, including the seam with
+  // the existing tail.
+  if (sorted) {
+    int prev = storage.empty() ? vals[0] : storage.back();
+    for (size_t i = 0; i < n; ++i) {
+      if (vals[i] < prev) { sorted = false; break; }
+      prev = vals[i];
+    }
+  }
+  if (index.isEnabled()) {
+    for (size_t i = 0; i < n; ++i) index.append(hashInt(vals[i]), (uint32_t)(storage.size() + i));
+  }
+  storage.insert(storage.end(), vals, vals + n);
+}
+
+int InternalIntColumn::getInt(size_t index) const {
+  if (index >= storage.size()) return 0;
+  return storage[index];
+}
+
+int InternalIntColumn::find(const std::string &pattern) const {
+  return findKey(resolveKey(pattern));
+}
+
+SnailKey InternalIntColumn::resolveKey(const std::string &pattern) const {
+  // FIX: Using atoi instead of stoi (No Exceptions)
+  SnailKey key = { true, std::atoi(pattern.c_str()), 0, 0.0 };
+  return key;
+}
+
+int InternalIntColumn::findKey(const SnailKey &key) const {
+  if (!key.valid) return -1;
+  int val = key.i;
+
+  if (sorted) {
+      // Binary Search
+      SNAIL_COUNT(findBinary, 1);
+      auto it = std::lower_bound(storage.begin(), storage.end(), val);
+      if (it != storage.end() && *it == val) {
+          return (int)std::distance(storage.begin(), it);
+      }
+  } else if (index.isEnabled()) {
+      // Hash Index
+      SNAIL_COUNT(findIndex, 1);
+      return index.find(hashInt(val), [&](uint32_t row) { return storage[row] == val; });
+  } else {
+      // Linear Scan
+      SNAIL_COUNT(findScan, 1);
+      for (size_t i = 0; i < storage.size(); ++i) {
+          if (storage[i] == val) return i;
+      }
+  }
+  return -1;
+}
+
+bool InternalIntColumn::indexLookup(const SnailKey &key, std::vector<uint32_t> &rows) const {
+  if (!index.isEnabled()) return false;
+  if (!key.valid) return true;
+  int val = key.i;
+  index.findAll(hashInt(val), [&](uint32_t row) { return storage[row] == val; }, rows);
+  return true;
+}
+
+void InternalIntColumn::addMemoryStats(SnailMemoryStats &stats) const {
+  addVectorBytes(stats.storage, storage);
+  index.addMemoryStats(stats.index);
+}
 
-  ColumnType getType() const override { return INT_TYPE; }
-  size_t size() const override { return storage.size(); }
-  void reserve(size_t n) override { storage.reserve(n); }
-  bool isSorted() const override { return sorted; }
-  bool isIndexed() const override { return !index.empty(); }
+void InternalIntColumn::createIndex() {
+  // From here on inserts and compaction keep the index current
+  std::vector<IndexEntry> entries(storage.size());
+  for (size_t i = 0; i < storage.size(); ++i) {
+      entries[i] = { hashInt(storage[i]), (uint32_t)i };
+  }
+  index.build(entries);
+}
+
+// --- InternalStrColumn ---
+
+InternalStrColumn::InternalStrColumn(size_t maxLen, bool orderedDict)
+    : maxLength(maxLen), orderedDict(orderedDict) {}
+
+ColumnType InternalStrColumn::getType() const { return STR_TYPE; }
+
+// Size is strictly rows, not bytes
+size_t InternalStrColumn::size() const { return data.size(); }
+
+void InternalStrColumn::reserve(size_t n) { data.reserve(n); }
+bool InternalStrColumn::isSorted() const { return sorted; }
+bool InternalStrColumn::isIndexed() const { return index.isEnabled(); }
+
+void InternalStrColumn::compact(const std::vector<bool> &keepMask) {
+    if (keepMask.size() != data.size()) return;
 
-  void compact(const std::vector<bool> &keepMask) override {
-    if (keepMask.size() != storage.size()) return;
-    
-    // Two-Pointer In-Place Compaction
     size_t dst = 0;
-    for (size_t i = 0; i < storage.size(); ++i) {
+    for (size_t i = 0; i < data.size(); ++i) {
         if (keepMask[i]) {
             if (dst != i) {
-                storage[dst] = storage[i];
+                data[dst] = data[i];
             }
             dst++;
         }
     }
-    storage.resize(dst);
-    // Index/Sort state is invalidated by compaction unless we re-verify
-    // For v1.0 simplicity, mark as unsorted/unindexed
-    sorted = false;
-    index.clear();
-  }
+    data.resize(dst);
+    // Removing rows keeps the tokens in order
+    index.compact(keepMask);
+    // Note: Dictionary is NOT compacted in v1.0 (Append-only dict)
+}
 
-  void addInt(int val) override {
-    if (sorted && !storage.empty()) {
-      if (val < storage.back())
-        sorted = false;
+void InternalStrColumn::addStr(const std::string &val) {
+    uint16_t token = 0;
+    // 1. Try to find in existing dictionary
+    int existingIdx = -1;
+    // Simple linear search on dictionary is slow, but dict is small.
+    // Optimization: Could use a map, but RAM usage... keeping simple for v1.0
+    for(size_t i=0; i<dictionary.size(); ++i) {
+        if(dictionary[i] == val) {
+            existingIdx = i;
+            break;
+        }
     }
-    storage.push_back(val);
-    if (!index.empty()) index.clear();
-  }
 
-  int getInt(size_t index) const override {
-    if (index >= storage.size()) return 0;
-    return storage[index];
+    if (existingIdx != -1) {
+        token = (uint16_t)existingIdx;
+    } else {
+        // Add new
+        if (dictionary.size() < 65535) {
+          dictionary.push_back(val);
+          token = (uint16_t)(dictionary.size() - 1);
+          noteNewEntry();
+        } else {
+          token = 0; // Overflow fallback
+        }
+    }
+    if (sorted && !data.empty() && token < data.back()) sorted = false;
+    index.append(token, (uint32_t)data.size());
+    data.push_back(token);
+}
+
+void InternalStrColumn::noteNewEntry() {
+    epoch++;
+    size_t n = dictionary.size();
+    if (dictSorted && n > 1 && dictionary[n - 1] < dictionary[n - 2]) dictSorted = false;
+}
+
+static inline const char *strPtr(const char *s) { return s ? s : ""; }
+static inline const char *strPtr(const std::string &s) { return s.data(); }
+static inline size_t strLen(const char *s) { return s ? std::strlen(s) : 0; }
+static inline size_t strLen(const std::string &s) { return s.size(); }
+
+// Batch interning: instead of a linear dictionary scan per row, the
+// dictionary is hashed once into a sorted (hash, token) table that lives for
+// the duration of the batch.
+std::vector<IndexEntry> InternalStrColumn::dictionaryLookup() const {
+    std::vector<IndexEntry> lookup(dictionary.size());
+    for (size_t t = 0; t < dictionary.size(); ++t) {
+        lookup[t] = { hashStr(dictionary[t].data(), dictionary[t].size()), (uint32_t)t };
+    }
+    std::sort(lookup.begin(), lookup.end());
+    return lookup;
+}
+
+// Token of s, appended to the dictionary (and to 'lookup') if new
+uint16_t InternalStrColumn::intern(std::vector<IndexEntry> &lookup, const char *s, size_t len) {
+    IndexEntry probe = { hashStr(s, len), 0 };
+    auto it = std::lower_bound(lookup.begin(), lookup.end(), probe);
+    for (; it != lookup.end() && it->hash == probe.hash; ++it) {
+        const std::string &d = dictionary[it->rowIdx];
+        if (d.size() == len && std::memcmp(d.data(), s, len) == 0) {
+            return (uint16_t)it->rowIdx;
+        }
+    }
+
+    if (dictionary.size() >= 65535) return 0; // Overflow fallback
+    dictionary.push_back(std::string(s, len));
+    noteNewEntry();
+    probe.rowIdx = (uint32_t)(dictionary.size() - 1);
+    lookup.insert(std::upper_bound(lookup.begin(), lookup.end(), probe), probe);
+    return (uint16_t)probe.rowIdx;
+}
+
+// Consecutive repeats skip the lookup entirely.
+template <typename S>
+void InternalStrColumn::addStrsImpl(const S *vals, size_t n) {
+    if (n == 0) return;
+
+    std::vector<IndexEntry> lookup = dictionaryLookup();
+    data.reserve(data.size() + n);
+    const char *prevPtr = nullptr;
+    size_t prevLen = 0;
+    uint16_t prevToken = 0;
+
+    for (size_t i = 0; i < n; ++i) {
+        const char *s = strPtr(vals[i]);
+        size_t len = strLen(vals[i]);
+
+        if (prevPtr && len == prevLen && std::memcmp(s, prevPtr, len) == 0) {
+            index.append(prevToken, (uint32_t)data.size());
+            data.push_back(prevToken); // Repeat: cannot break 'sorted'
+            continue;
+        }
+
+        uint16_t token = intern(lookup, s, len);
+        if (sorted && !data.empty() && token < data.back()) sorted = false;
+        index.append(token, (uint32_t)data.size());
+        data.push_back(token);
+        prevPtr = s;
+        prevLen = len;
+        prevToken = token;
+    }
+}
+
+void InternalStrColumn::addTokens(const std::vector<std::string> &localDict,
+                                  const uint16_t *tokens, size_t n) {
+    if (n == 0) return;
+
+    // One dictionary lookup per distinct value, then integer remapping only
+    std::vector<IndexEntry> lookup = dictionaryLookup();
+    std::vector<uint16_t> remap(localDict.size());
+    for (size_t t = 0; t < localDict.size(); ++t) {
+        remap[t] = intern(lookup, localDict[t].data(), localDict[t].size());
+    }
+
+    data.reserve(data.size() + n);
+    for (size_t i = 0; i < n; ++i) {
+        uint16_t token = tokens[i] < remap.size() ? remap[tokens[i]] : 0;
+        if (sorted && !data.empty() && token < data.back()) sorted = false;
+        index.append(token, (uint32_t)data.size());
+        data.push_back(token);
+    }
+}
+
+void InternalStrColumn::addStrs(const char *const *vals, size_t n) { addStrsImpl(vals, n); }
+void InternalStrColumn::addStrs(const std::string *vals, size_t n) { addStrsImpl(vals, n); }
+
+std::string InternalStrColumn::getStr(size_t index) const {
+  if (index >= data.size()) return "";
+  uint16_t token = data[index];
+  if (token < dictionary.size()) {
+      return dictionary[token];
   }
+  return "";
+}
 
-  int find(const std::string &pattern) const override {
-    // FIX: Using atoi instead of stoi (No Exceptions)
-    int val = std::atoi(pattern.c_str());
-    
-    if (sorted) {
-        // Binary Search
-        auto it = std::lower_bound(storage.begin(), storage.end(), val);
-        if (it != storage.end() && *it == val) {
-            return (int)std::distance(storage.begin(), it);
+int InternalStrColumn::find(const std::string &pattern) const {
+    return findKey(resolveKey(pattern));
+}
+
+SnailKey InternalStrColumn::resolveKey(const std::string &pattern) const {
+    // 1. Find token for pattern
+    SnailKey key = { false, -1, 0, 0.0 };
+    for(size_t i=0; i<dictionary.size(); ++i) {
+        if(dictionary[i] == pattern) {
+            key.valid = true;
+            key.i = (int32_t)i;
+            break;
         }
-    } else {
-        // Linear Scan
-        for (size_t i = 0; i < storage.size(); ++i) {
-            if (storage[i] == val) return i;
+    }
+    return key;
+}
+
+int InternalStrColumn::findKey(const SnailKey &key) const {
+    // Fast Fail: Token not in dict? Value not in DB.
+    if (!key.valid) {
+        SNAIL_COUNT(findDictMiss, 1);
+        return -1;
+    }
+    uint16_t targetToken = (uint16_t)key.i;
+
+    // 2. Find token in data
+    if (sorted) {
+        SNAIL_COUNT(findBinary, 1);
+        auto it = std::lower_bound(data.begin(), data.end(), targetToken);
+        if (it != data.end() && *it == targetToken) {
+            return (int)std::distance(data.begin(), it);
         }
+        return -1;
+    }
+    if (index.isEnabled()) {
+        SNAIL_COUNT(findIndex, 1);
+        return index.find(targetToken, [](uint32_t) { return true; });
+    }
+    SNAIL_COUNT(findScan, 1);
+    for (size_t i = 0; i < data.size(); ++i) {
+        if (data[i] == targetToken) return i;
     }
     return -1;
-  }
+}
+
+bool InternalStrColumn::indexLookup(const SnailKey &key, std::vector<uint32_t> &rows) const {
+    if (!index.isEnabled()) return false;
+    if (!key.valid) return true;
+    index.findAll((uint16_t)key.i, [](uint32_t) { return true; }, rows);
+    return true;
+}
+
+uint32_t InternalStrColumn::getEpoch() const { return epoch; }
+
+void InternalStrColumn::addMemoryStats(SnailMemoryStats &stats) const {
+    addVectorBytes(stats.tokens, data);
+    addDictionaryBytes(stats.dictionary, dictionary);
+    index.addMemoryStats(stats.index);
+}
+
+void InternalStrColumn::createIndex() {
+    if (orderedDict) sortDictionary();
+    buildIndex();
+}
 
-  void createIndex() override {
-    if (storage.empty()) return;
-    index.resize(storage.size());
-    for (size_t i = 0; i < storage.size(); ++i) {
-        index[i] = { hashInt(storage[i]), (uint16_t)i };
+void InternalStrColumn::buildIndex() {
+    // Tokens are already unique per string: use them as the hash
+    std::vector<IndexEntry> entries(data.size());
+    for (size_t i = 0; i < data.size(); ++i) {
+        entries[i] = { data[i], (uint32_t)i };
     }
-    std::sort(index.begin(), index.end());
-  }
+    index.build(entries);
+}
 
-  // Friends for Persistence
-  friend class SnailStorage;
+void InternalStrColumn::sortDictionary() {
+    if (dictSorted) return;
 
-protected:
-    char* getWritableBuffer() override { return reinterpret_cast<char*>(storage.data()); }
-    void resizeStorage(size_t bytes) override { 
-        size_t count = bytes / sizeof(int);
-        storage.resize(count);
-        sorted = false; 
-        index.clear();
+    size_t n = dictionary.size();
+    std::vector<uint16_t> order(n);
+    for (size_t t = 0; t < n; ++t) order[t] = (uint16_t)t;
+    std::sort(order.begin(), order.end(), [this](uint16_t a, uint16_t b) {
+        return dictionary[a] < dictionary[b];
+    });
+
+    // order[newToken] = oldToken -> remap[oldToken] = newToken
+    std::vector<uint16_t> remap(n);
+    std::vector<std::string> sortedDict(n);
+    for (size_t t = 0; t < n; ++t) {
+        remap[order[t]] = (uint16_t)t;
+        sortedDict[t].swap(dictionary[order[t]]);
     }
+    dictionary.swap(sortedDict);
 
-private:
-  std::vector<int> storage;
-  std::vector<IndexEntry> index;
-  bool sorted = true;
-};
+    for (auto &token : data) {
+        if (token < n) token = remap[token];
+    }
 
-// --- InternalStrColumn ---
+    sorted = std::is_sorted(data.begin(), data.end());
+    dictSorted = true;
+    if (index.isEnabled()) buildIndex();
+    epoch++; // Prepared tokens are stale
+}
 
-class InternalStrColumn : public Column {
-public:
-  InternalStrColumn(size_t maxLen) : maxLength(maxLen) {}
-
-  ColumnType getType() const override { return STR_TYPE; }
-  
-  // Size is strictly rows, not bytes
-  size_t size() const override { return data.size(); }
-  
-  void reserve(size_t n) override { data.reserve(n); }
-  bool isSorted() const override { return sorted; }
-  bool isIndexed() const override { return !index.empty(); }
-
-  void compact(const std::vector<bool> &keepMask) override {
-      if (keepMask.size() != data.size()) return;
-
-      size_t dst = 0;
-      for (size_t i = 0; i < data.size(); ++i) {
-          if (keepMask[i]) {
-              if (dst != i) {
-                  data[dst] = data[i];
-              }
-              dst++;
-          }
-      }
-      data.resize(dst);
-      sorted = false;
-      index.clear();
-      // Note: Dictionary is NOT compacted in v1.0 (Append-only dict)
-  }
-
-  void addStr(const std::string &val) override {
-      uint16_t token = 0;
-      // 1. Try to find in existing dictionary
-      int existingIdx = -1;
-      // Simple linear search on dictionary is slow, but dict is small.
-      // Optimization: Could use a map, but RAM usage... keeping simple for v1.0
-      for(size_t i=0; i<dictionary.size(); ++i) {
-          if(dictionary[i] == val) {
-              existingIdx = i;
-              break;
-          }
-      }
+// First token whose string is >= value (or > value when !inclusive)
+static uint16_t dictBound(const std::vector<std::string> &dict, const std::string &value,
+                          bool inclusive) {
+    auto it = inclusive ? std::lower_bound(dict.begin(), dict.end(), value)
+                        : std::upper_bound(dict.begin(), dict.end(), value);
+    return (uint16_t)(it - dict.begin());
+}
 
-      if (existingIdx != -1) {
-          token = (uint16_t)existingIdx;
-      } else {
-          // Add new
-          if (dictionary.size() < 65535) {
-            dictionary.push_back(val);
-            token = (uint16_t)(dictionary.size() - 1);
-          } else {
-            token = 0; // Overflow fallback
+SnailTokenSet InternalStrColumn::matchRange(const std::string *lo, bool loInclusive,
+                                            const std::string *hi, bool hiInclusive) const {
+    SnailTokenSet set;
+    set.isRange = dictSorted;
+    set.lo = 0;
+    set.hi = 0;
+
+    if (dictSorted) {
+        set.lo = lo ? dictBound(dictionary, *lo, loInclusive) : 0;
+        set.hi = hi ? dictBound(dictionary, *hi, !hiInclusive) : (uint16_t)dictionary.size();
+        if (set.hi < set.lo) set.hi = set.lo;
+        return set;
+    }
+
+    // Unordered dictionary: still one comparison per distinct string
+    set.mask.resize(dictionary.size());
+    for (size_t t = 0; t < dictionary.size(); ++t) {
+        const std::string &d = dictionary[t];
+        bool ok = true;
+        if (lo) ok = loInclusive ? !(d < *lo) : (*lo < d);
+        if (ok && hi) ok = hiInclusive ? !(*hi < d) : (d < *hi);
+        set.mask[t] = ok ? 1 : 0;
+    }
+    return set;
+}
+
+SnailTokenSet InternalStrColumn::matchPrefix(const std::string &prefix) const {
+    if (!dictSorted) {
+        SnailTokenSet set;
+        set.isRange = false;
+        set.lo = set.hi = 0;
+        set.mask.resize(dictionary.size());
+        for (size_t t = 0; t < dictionary.size(); ++t) {
+            set.mask[t] = dictionary[t].compare(0, prefix.size(), prefix) == 0 ? 1 : 0;
+        }
+        return set;
+    }
+
+    // Strings with the prefix sort in [prefix, successor(prefix))
+    std::string end = prefix;
+    while (!end.empty() && (unsigned char)end.back() == 0xFF) end.pop_back();
+    if (end.empty()) return matchRange(&prefix, true, nullptr, false);
+    end.back() = (char)((unsigned char)end.back() + 1);
+    return matchRange(&prefix, true, &end, false);
+}
+
+void InternalStrColumn::selectRows(const SnailTokenSet &set, const std::vector<bool> &active,
+                                   std::vector<uint32_t> &out) const {
+    size_t begin = 0, end = data.size();
+    if (set.isRange && sorted) {
+        // Sorted tokens + token range: the matching rows are contiguous
+        begin = std::lower_bound(data.begin(), data.end(), set.lo) - data.begin();
+        end = std::lower_bound(data.begin() + begin, data.end(), set.hi) - data.begin();
+        for (size_t i = begin; i < end; ++i) {
+            if (active[i]) out.push_back((uint32_t)i);
+        }
+        return;
+    }
+    if (set.isRange) {
+        for (size_t i = begin; i < end; ++i) {
+            uint16_t t = data[i];
+            if (t >= set.lo && t < set.hi && active[i]) out.push_back((uint32_t)i);
+        }
+        return;
+    }
+    for (size_t i = begin; i < end; ++i) {
+        if (set.contains(data[i]) && active[i]) out.push_back((uint32_t)i);
+    }
+}
+
+std::vector<uint16_t> InternalStrColumn::dictionaryRanks() const {
+    size_t n = dictionary.size();
+    std::vector<uint16_t> ranks(n);
+    for (size_t t = 0; t < n; ++t) ranks[t] = (uint16_t)t;
+    if (dictSorted) return ranks;
+
+    std::vector<uint16_t> order(ranks);
+    std::sort(order.begin(), order.end(), [this](uint16_t a, uint16_t b) {
+        return dictionary[a] < dictionary[b];
+    });
+    for (size_t r = 0; r < n; ++r) ranks[order[r]] = (uint16_t)r;
+    return ranks;
+}
+
+// --- InternalNumColumn (INT64 / FLOAT / DOUBLE) ---
+
+static inline void setKey(SnailKey &key, int64_t val) { key.l = val; }
+static inline void setKey(SnailKey &key, float val) { key.d = val; }
+static inline void setKey(SnailKey &key, double val) { key.d = val; }
+static inline int64_t keyValue(const SnailKey &key, int64_t) { return key.l; }
+static inline float keyValue(const SnailKey &key, float) { return (float)key.d; }
+static inline double keyValue(const SnailKey &key, double) { return key.d; }
+
+static inline int64_t parseNum(const std::string &s, int64_t) {
+  return (int64_t)std::strtoll(s.c_str(), nullptr, 10);
+}
+static inline float parseNum(const std::string &s, float) {
+  return (float)std::strtod(s.c_str(), nullptr);
+}
+static inline double parseNum(const std::string &s, double) {
+  return std::strtod(s.c_str(), nullptr);
+}
+
+template <typename T, ColumnType TYPE>
+InternalNumColumn<T, TYPE>::InternalNumColumn() {}
+
+template <typename T, ColumnType TYPE>
+ColumnType InternalNumColumn<T, TYPE>::getType() const { return TYPE; }
+template <typename T, ColumnType TYPE>
+size_t InternalNumColumn<T, TYPE>::size() const { return storage.size(); }
+template <typename T, ColumnType TYPE>
+void InternalNumColumn<T, TYPE>::reserve(size_t n) { storage.reserve(n); }
+template <typename T, ColumnType TYPE>
+bool InternalNumColumn<T, TYPE>::isSorted() const { return sorted; }
+template <typename T, ColumnType TYPE>
+bool InternalNumColumn<T, TYPE>::isIndexed() const { return false; }
+
+template <typename T, ColumnType TYPE>
+void InternalNumColumn<T, TYPE>::compact(const std::vector<bool> &keepMask) {
+  if (keepMask.size() != storage.size()) return;
+
+  size_t dst = 0;
+  for (size_t i = 0; i < storage.size(); ++i) {
+      if (keepMask[i]) {
+          if (dst != i) {
+              storage[dst] = storage[i];
           }
+          dst++;
       }
-      data.push_back(token);
-      sorted = false; 
-      if(!index.empty()) index.clear();
   }
+  storage.resize(dst);
+  // Removing rows from a sorted sequence leaves it sorted
+}
 
-  std::string getStr(size_t index) const override {
-    if (index >= data.size()) return "";
-    uint16_t token = data[index];
-    if (token < dictionary.size()) {
-        return dictionary[token];
-    }
-    return "";
+template <typename T, ColumnType TYPE>
+void InternalNumColumn<T, TYPE>::append(T val) {
+  // Negated >= so that a NaN (unordered) also clears the flag
+  if (sorted && !storage.empty()) {
+    if (!(val >= storage.back()))
+      sorted = false;
+  }
+  storage.push_back(val);
+}
+
+template <typename T, ColumnType TYPE>
+template <typename S>
+void InternalNumColumn<T, TYPE>::appendAll(const S *vals, size_t n) {
+  storage.reserve(storage.size() + n);
+  for (size_t i = 0; i < n; ++i) {
+    append((T)vals[i]);
   }
+}
 
-  int find(const std::string &pattern) const override {
-      // 1. Find token for pattern
-      int targetToken = -1;
-      for(size_t i=0; i<dictionary.size(); ++i) {
-          if(dictionary[i] == pattern) {
-              targetToken = i;
-              break;
-          }
+template <typename T, ColumnType TYPE>
+void InternalNumColumn<T, TYPE>::addInt64(int64_t val) { append((T)val); }
+template <typename T, ColumnType TYPE>
+void InternalNumColumn<T, TYPE>::addFloat(float val) { append((T)val); }
+template <typename T, ColumnType TYPE>
+void InternalNumColumn<T, TYPE>::addDouble(double val) { append((T)val); }
+
+template <typename T, ColumnType TYPE>
+void InternalNumColumn<T, TYPE>::addInt64s(const int64_t *vals, size_t n) { appendAll(vals, n); }
+template <typename T, ColumnType TYPE>
+void InternalNumColumn<T, TYPE>::addFloats(const float *vals, size_t n) { appendAll(vals, n); }
+template <typename T, ColumnType TYPE>
+void InternalNumColumn<T, TYPE>::addDoubles(const double *vals, size_t n) { appendAll(vals, n); }
+
+template <typename T, ColumnType TYPE>
+int InternalNumColumn<T, TYPE>::getInt(size_t index) const {
+  if (index >= storage.size()) return 0;
+  return (int)storage[index];
+}
+template <typename T, ColumnType TYPE>
+int64_t InternalNumColumn<T, TYPE>::getInt64(size_t index) const {
+  if (index >= storage.size()) return 0;
+  return (int64_t)storage[index];
+}
+template <typename T, ColumnType TYPE>
+float InternalNumColumn<T, TYPE>::getFloat(size_t index) const {
+  if (index >= storage.size()) return 0.0f;
+  return (float)storage[index];
+}
+template <typename T, ColumnType TYPE>
+double InternalNumColumn<T, TYPE>::getDouble(size_t index) const {
+  if (index >= storage.size()) return 0.0;
+  return (double)storage[index];
+}
+
+template <typename T, ColumnType TYPE>
+void InternalNumColumn<T, TYPE>::createIndex() {
+  // Not implemented: sorted telemetry (counters, time series) already gets
+  // binary search
+}
+
+template <typename T, ColumnType TYPE>
+int InternalNumColumn<T, TYPE>::find(const std::string &pattern) const {
+  return findKey(resolveKey(pattern));
+}
+
+template <typename T, ColumnType TYPE>
+SnailKey InternalNumColumn<T, TYPE>::resolveKey(const std::string &pattern) const {
+  SnailKey key = { true, 0, 0, 0.0 };
+  setKey(key, parseNum(pattern, T()));
+  return key;
+}
+
+template <typename T, ColumnType TYPE>
+int InternalNumColumn<T, TYPE>::findKey(const SnailKey &key) const {
+  if (!key.valid) return -1;
+  T val = keyValue(key, T());
+
+  if (sorted) {
+      // Binary Search
+      SNAIL_COUNT(findBinary, 1);
+      auto it = std::lower_bound(storage.begin(), storage.end(), val);
+      if (it != storage.end() && *it == val) {
+          return (int)std::distance(storage.begin(), it);
       }
-      
-      // Fast Fail: Token not in dict? Value not in DB.
-      if (targetToken == -1) return -1;
+  } else {
+      // Linear Scan
+      SNAIL_COUNT(findScan, 1);
+      for (size_t i = 0; i < storage.size(); ++i) {
+          if (storage[i] == val) return i;
+      }
+  }
+  return -1;
+}
+
+template <typename T, ColumnType TYPE>
+void InternalNumColumn<T, TYPE>::addMemoryStats(SnailMemoryStats &stats) const {
+  addVectorBytes(stats.storage, storage);
+}
+
+template class InternalNumColumn<int64_t, INT64_TYPE>;
+template class InternalNumColumn<float, FLOAT_TYPE>;
+template class InternalNumColumn<double, DOUBLE_TYPE>;
 
-      // 2. Find token in data
-      for (size_t i = 0; i < data.size(); ++i) {
-          if (data[i] == targetToken) return i;
+// --- InternalBoolColumn ---
+
+InternalBoolColumn::InternalBoolColumn() {}
+
+ColumnType InternalBoolColumn::getType() const { return BOOL_TYPE; }
+size_t InternalBoolColumn::size() const { return count; }
+void InternalBoolColumn::reserve(size_t n) { bits.reserve((n + 7) / 8); }
+bool InternalBoolColumn::isSorted() const { return false; }
+bool InternalBoolColumn::isIndexed() const { return false; }
+
+void InternalBoolColumn::compact(const std::vector<bool> &keepMask) {
+  if (keepMask.size() != count) return;
+
+  // Bits are only ever moved towards the front, so the same buffer is safe
+  size_t dst = 0;
+  for (size_t i = 0; i < count; ++i) {
+      if (keepMask[i]) {
+          if (dst != i) {
+              uint8_t mask = (uint8_t)(1u << (dst & 7));
+              if (bits[i >> 3] & (1u << (i & 7))) bits[dst >> 3] |= mask;
+              else bits[dst >> 3] &= (uint8_t)~mask;
+          }
+          dst++;
       }
-      return -1;
   }
+  count = dst;
+  bits.resize((count + 7) / 8);
+  // Keep the padding bits of the last byte clear
+  if (count & 7) bits.back() &= (uint8_t)((1u << (count & 7)) - 1);
+}
+
+void InternalBoolColumn::addBool(bool val) {
+  if ((count & 7) == 0) bits.push_back(0);
+  if (val) bits.back() |= (uint8_t)(1u << (count & 7));
+  count++;
+}
 
-  void createIndex() override {
-      // Not implemented for v1.0 Str (Dictionary is already an index of sorts)
+void InternalBoolColumn::addBools(const bool *vals, size_t n) {
+  bits.reserve((count + n + 7) / 8);
+  for (size_t i = 0; i < n; ++i) {
+    addBool(vals[i]);
   }
-  
-  // Friends for Persistence
-  friend class SnailStorage;
+}
 
-protected:
-    char* getWritableBuffer() override { return reinterpret_cast<char*>(data.data()); }
-    void resizeStorage(size_t bytes) override {
-        size_t count = bytes / sizeof(uint16_t);
-        data.resize(count);
-        sorted = false;
-    }
+bool InternalBoolColumn::getBool(size_t index) const {
+  if (index >= count) return false;
+  return (bits[index >> 3] >> (index & 7)) & 1u;
+}
+
+int InternalBoolColumn::getInt(size_t index) const { return getBool(index) ? 1 : 0; }
+
+void InternalBoolColumn::createIndex() {}
+
+void InternalBoolColumn::addMemoryStats(SnailMemoryStats &stats) const {
+  addVectorBytes(stats.storage, bits);
+}
 
-private:
-  size_t maxLength;
-  std::vector<std::string> dictionary;
-  std::vector<uint16_t> data; // Tokens
-  std::vector<IndexEntry> index;
-  bool sorted = false; // Strings rarely inserted sorted
-};
+int InternalBoolColumn::find(const std::string &pattern) const {
+  return findKey(resolveKey(pattern));
+}
+
+SnailKey InternalBoolColumn::resolveKey(const std::string &pattern) const {
+  // Accepts "true"/"false" as well as numbers (non-zero = true)
+  SnailKey key = { true, 0, 0, 0.0 };
+  if (pattern == "true") key.i = 1;
+  else if (pattern != "false") key.i = std::atoi(pattern.c_str()) != 0 ? 1 : 0;
+  return key;
+}
+
+int InternalBoolColumn::findKey(const SnailKey &key) const {
+  if (!key.valid) return -1;
+  SNAIL_COUNT(findScan, 1);
+  // Whole bytes that cannot contain a match are skipped
+  uint8_t skip = key.i ? 0x00 : 0xFF;
+  for (size_t b = 0; b < bits.size(); ++b) {
+    if (bits[b] == skip) continue;
+    for (size_t i = b * 8; i < count && i < b * 8 + 8; ++i) {
+      if (getBool(i) == (key.i != 0)) return (int)i;
+    }
+  }
+  return -1;
+}
 
 // =========================================================
 // SnailDB Implementation
 // =========================================================
 
-SnailDB::SnailDB() : numRows(0), cursor(0) {}
+SnailDB::SnailDB() : tsSorted(true), numRows(0), cursor(0), schemaEpoch(0) {}
 
 SnailDB::~SnailDB() {}
 
-void SnailDB::addStrColProp(const std::string &colName, size_t max_length) {
+void SnailDB::addStrColProp(const std::string &colName, size_t max_length,
+                            bool orderedDict) {
   colNames.push_back(colName);
-  colInfos.push_back({colName, max_length, STR_TYPE});
-  columns.push_back(std::unique_ptr<Column>(new InternalStrColumn(max_length)));
+  colInfos.push_back({colName, max_length, STR_TYPE, orderedDict});
+  columns.push_back(std::unique_ptr<Column>(new InternalStrColumn(max_length, orderedDict)));
+  schemaEpoch++;
 }
 
 void SnailDB::addIntColProp(const std::string &colName, size_t max_length) {
   colNames.push_back(colName);
-  colInfos.push_back({colName, max_length, INT_TYPE});
+  colInfos.push_back({colName, max_length, INT_TYPE, false});
   columns.push_back(std::unique_ptr<Column>(new InternalIntColumn()));
+  schemaEpoch++;
+}
+
+void SnailDB::addInt64ColProp(const std::string &colName, size_t max_length) {
+  colNames.push_back(colName);
+  colInfos.push_back({colName, max_length, INT64_TYPE, false});
+  columns.push_back(std::unique_ptr<Column>(new InternalInt64Column()));
+  schemaEpoch++;
+}
+
+void SnailDB::addFloatColProp(const std::string &colName, size_t max_length) {
+  colNames.push_back(colName);
+  colInfos.push_back({colName, max_length, FLOAT_TYPE, false});
+  columns.push_back(std::unique_ptr<Column>(new InternalFloatColumn()));
+  schemaEpoch++;
+}
+
+void SnailDB::addDoubleColProp(const std::string &colName, size_t max_length) {
+  colNames.push_back(colName);
+  colInfos.push_back({colName, max_length, DOUBLE_TYPE, false});
+  columns.push_back(std::unique_ptr<Column>(new InternalDoubleColumn()));
+  schemaEpoch++;
+}
+
+void SnailDB::addBoolColProp(const std::string &colName, size_t max_length) {
+  colNames.push_back(colName);
+  colInfos.push_back({colName, max_length, BOOL_TYPE, false});
+  columns.push_back(std::unique_ptr<Column>(new InternalBoolColumn()));
+  schemaEpoch++;
+}
+
+void SnailDB::addColProp(const std::string &colName, size_t max_length, ColumnType type,
+                         bool orderedDict) {
+  switch (type) {
+  case STR_TYPE: addStrColProp(colName, max_length, orderedDict); break;
+  case INT_TYPE: addIntColProp(colName, max_length); break;
+  case INT64_TYPE: addInt64ColProp(colName, max_length); break;
+  case FLOAT_TYPE: addFloatColProp(colName, max_length); break;
+  case DOUBLE_TYPE: addDoubleColProp(colName, max_length); break;
+  case BOOL_TYPE: addBoolColProp(colName, max_length); break;
+  }
 }
 
 void SnailDB::reserve(size_t rows) {
@@ -264,9 +969,30 @@ void SnailDB::createIndex() {
 }
 
 // Typed Dispatch
-void SnailDB::addToCol(size_t colIdx, int val) {
+void SnailDB::addIntegral(size_t colIdx, int64_t val) {
+  if (colIdx >= columns.size()) return;
+  Column *col = columns[colIdx].get();
+  switch (col->getType()) {
+  case INT_TYPE: col->addInt((int)val); break;
+  case INT64_TYPE: col->addInt64(val); break;
+  case FLOAT_TYPE: col->addFloat((float)val); break;
+  case DOUBLE_TYPE: col->addDouble((double)val); break;
+  case BOOL_TYPE: col->addBool(val != 0); break;
+  case STR_TYPE: col->addInt((int)val); break; // Ignored, as in v1.0
+  }
+}
+
+void SnailDB::addFloating(size_t colIdx, double val) {
   if (colIdx >= columns.size()) return;
-  columns[colIdx]->addInt(val);
+  Column *col = columns[colIdx].get();
+  switch (col->getType()) {
+  case INT_TYPE: col->addInt((int)val); break;
+  case INT64_TYPE: col->addInt64((int64_t)val); break;
+  case FLOAT_TYPE: col->addFloat((float)val); break;
+  case DOUBLE_TYPE: col->addDouble(val); break;
+  case BOOL_TYPE: col->addBool(val != 0.0); break;
+  case STR_TYPE: break; // Ignored, as in v1.0
+  }
 }
 
 void SnailDB::addToCol(size_t colIdx, const std::string &val) {
@@ -278,6 +1004,83 @@ void SnailDB::addToCol(size_t colIdx, const char *val) {
   addToCol(colIdx, std::string(val));
 }
 
+// Bulk Insert
+void SnailBatch::set(size_t colIdx, ColumnType type, const void *data, bool stdString) {
+  if (colIdx >= slices.size()) {
+    Slice unset = {INT_TYPE, nullptr, false};
+    slices.resize(colIdx + 1, unset);
+  }
+  Slice slice = {type, data, stdString};
+  slices[colIdx] = slice;
+}
+
+bool SnailDB::insertBatch(const SnailBatch &batch) {
+  // Validate the whole batch first so a bad slice cannot leave the columns
+  // with different lengths.
+  if (batch.slices.size() != columns.size()) return false;
+  for (size_t c = 0; c < columns.size(); ++c) {
+    const SnailBatch::Slice &slice = batch.slices[c];
+    if (!slice.data || slice.type != columns[c]->getType()) return false;
+  }
+
+  size_t n = batch.rows;
+  if (n == 0) return true;
+  SNAIL_TIMED(insertTime);
+  SNAIL_COUNT(batchInserts, 1);
+  SNAIL_COUNT(rowsInserted, (uint32_t)n);
+
+  for (size_t c = 0; c < columns.size(); ++c) {
+    const SnailBatch::Slice &slice = batch.slices[c];
+    switch (slice.type) {
+    case INT_TYPE:
+      columns[c]->addInts(static_cast<const int *>(slice.data), n);
+      break;
+    case INT64_TYPE:
+      columns[c]->addInt64s(static_cast<const int64_t *>(slice.data), n);
+      break;
+    case FLOAT_TYPE:
+      columns[c]->addFloats(static_cast<const float *>(slice.data), n);
+      break;
+    case DOUBLE_TYPE:
+      columns[c]->addDoubles(static_cast<const double *>(slice.data), n);
+      break;
+    case BOOL_TYPE:
+      columns[c]->addBools(static_cast<const bool *>(slice.data), n);
+      break;
+    case STR_TYPE:
+      if (slice.stdString) {
+        columns[c]->addStrs(static_cast<const std::string *>(slice.data), n);
+      } else {
+        columns[c]->addStrs(static_cast<const char *const *>(slice.data), n);
+      }
+      break;
+    }
+  }
+
+  // System fields
+  activeRows.insert(activeRows.end(), n, true);
+  size_t tsStart = timestamps.size();
+  if (batch.ts) {
+    timestamps.insert(timestamps.end(), batch.ts, batch.ts + n);
+  } else {
+    timestamps.insert(timestamps.end(), n, batch.fixedTs);
+  }
+  if (tsSorted) {
+    size_t from = tsStart ? tsStart - 1 : 0; // Include the seam
+    tsSorted = std::is_sorted(timestamps.begin() + from, timestamps.end());
+  }
+  numRows += n;
+  return true;
+}
+
+void SnailDB::appendRow(uint32_t ts) {
+  SNAIL_COUNT(rowsInserted, 1);
+  activeRows.push_back(true);
+  if (!timestamps.empty() && ts < timestamps.back()) tsSorted = false;
+  timestamps.push_back(ts);
+  numRows++;
+}
+
 // Lifecycle Management
 void SnailDB::softDelete(size_t index) {
     if (index < activeRows.size()) {
@@ -295,12 +1098,18 @@ void SnailDB::deleteOlderThan(uint32_t threshold) {
 
 void SnailDB::purge() {
     if (activeRows.empty()) return;
+    SNAIL_TIMED(purgeTime);
+    SNAIL_COUNT(purges, 1);
 
     // 1. Compact all columns
     for (auto &col : columns) {
         col->compact(activeRows);
     }
 
+    compactSystem();
+}
+
+void SnailDB::compactSystem() {
     // 2. Compact timestamps
     size_t dst = 0;
     for (size_t i = 0; i < timestamps.size(); ++i) {
@@ -363,19 +1172,158 @@ int SnailDB::getColIndex(const std::string &name) const {
   return -1;
 }
 
+// String Range Queries
+const InternalStrColumn *SnailDB::strColumn(const std::string &colName) const {
+  int idx = getColIndex(colName);
+  if (idx == -1 || columns[idx]->getType() != STR_TYPE) return nullptr;
+  return static_cast<const InternalStrColumn *>(columns[idx].get());
+}
+
+bool SnailDB::sortDictionary(const std::string &colName) {
+  InternalStrColumn *col = const_cast<InternalStrColumn *>(strColumn(colName));
+  if (!col) return false;
+  col->sortDictionary();
+  return true;
+}
+
+std::vector<uint32_t> SnailDB::findLessThan(const std::string &colName,
+                                            const std::string &value) const {
+  std::vector<uint32_t> rows;
+  const InternalStrColumn *col = strColumn(colName);
+  if (col) col->selectRows(col->matchRange(nullptr, false, &value, false), activeRows, rows);
+  return rows;
+}
+
+std::vector<uint32_t> SnailDB::findBetween(const std::string &colName, const std::string &lo,
+                                           const std::string &hi) const {
+  std::vector<uint32_t> rows;
+  const InternalStrColumn *col = strColumn(colName);
+  if (col) col->selectRows(col->matchRange(&lo, true, &hi, true), activeRows, rows);
+  return rows;
+}
+
+std::vector<uint32_t> SnailDB::findPrefix(const std::string &colName,
+                                          const std::string &prefix) const {
+  std::vector<uint32_t> rows;
+  const InternalStrColumn *col = strColumn(colName);
+  if (col) col->selectRows(col->matchPrefix(prefix), activeRows, rows);
+  return rows;
+}
+
+SnailMemoryStats SnailDB::getColMemoryStats(size_t idx) const {
+  SnailMemoryStats stats = SnailMemoryStats();
+  if (idx < columns.size()) columns[idx]->addMemoryStats(stats);
+  return stats;
+}
+
+SnailMemoryStats SnailDB::getMemoryStats() const {
+  SnailMemoryStats stats = SnailMemoryStats();
+  for (const auto &col : columns) {
+    col->addMemoryStats(stats);
+  }
+  // std::vector<bool> packs 1 bit per row
+  stats.tombstones.used = (activeRows.size() + 7) / 8;
+  stats.tombstones.reserved = (activeRows.capacity() + 7) / 8;
+  addVectorBytes(stats.timestamps, timestamps);
+  return stats;
+}
+
 ColumnType SnailDB::getColType(size_t idx) const {
     if (idx < colInfos.size()) return colInfos[idx].type;
     return INT_TYPE; // default
 }
 
+bool SnailDB::hasOrderedDictionary(size_t idx) const {
+  return idx < colInfos.size() && colInfos[idx].orderedDict;
+}
+
 int SnailDB::findRow(const std::string &colName, const std::string &value) const {
   int idx = getColIndex(colName);
   if (idx == -1) return -1;
-  int foundIdx = columns[idx]->find(value);
-  
+  return activeOrNone(columns[idx]->find(value));
+}
+
+int SnailDB::activeOrNone(int foundIdx) const {
   // Verify if valid
   if (foundIdx != -1 && foundIdx < (int)activeRows.size() && !activeRows[foundIdx]) {
       return -1; // Found but deleted
   }
   return foundIdx;
-}
\ No newline at end of file
+}
+
+// Prepared Lookups
+bool SnailDB::refresh(SnailColumnHandle &col) const {
+  // Epochs start at 0 in every table: a handle from another table is stale
+  if (col.column && col.owner == this && col.schemaEpoch == schemaEpoch) return true;
+
+  col.colIdx = getColIndex(col.colName);
+  if (col.colIdx == -1) {
+    col.column = nullptr;
+    return false;
+  }
+  col.column = columns[col.colIdx].get();
+  col.type = col.column->getType();
+  col.owner = this;
+  col.schemaEpoch = schemaEpoch;
+  return true;
+}
+
+SnailColumnHandle SnailDB::prepareColumn(const std::string &colName) const {
+  SnailColumnHandle col(colName);
+  refresh(col);
+  return col;
+}
+
+SnailPredicate SnailDB::prepare(const std::string &colName, const std::string &value) const {
+  SnailPredicate pred(colName, value);
+  resolve(pred);
+  return pred;
+}
+
+bool SnailDB::resolve(SnailPredicate &pred) const {
+  if (!refresh(pred.col)) return false;
+
+  const Column *col = pred.col.column;
+  uint32_t epoch = col->getEpoch();
+  if (!pred.resolved || pred.keyOwner != this || pred.keySchemaEpoch != pred.col.schemaEpoch ||
+      pred.keyEpoch != epoch) {
+    pred.key = col->resolveKey(pred.value);
+    pred.keyOwner = this;
+    pred.keySchemaEpoch = pred.col.schemaEpoch;
+    pred.keyEpoch = epoch;
+    pred.resolved = true;
+  }
+  return true;
+}
+
+int SnailDB::findRow(SnailPredicate &pred) const {
+  if (!resolve(pred)) return -1;
+  return activeOrNone(pred.col.column->findKey(pred.key));
+}
+
+int SnailDB::findRow(SnailColumnHandle &col, int value) const {
+  if (!refresh(col)) return -1;
+  if (col.type == INT64_TYPE) return findRow(col, (int64_t)value);
+  if (col.type == FLOAT_TYPE || col.type == DOUBLE_TYPE) return findRow(col, (double)value);
+  if (col.type != INT_TYPE && col.type != BOOL_TYPE) return -1;
+  SnailKey key = { true, value, 0, 0.0 };
+  if (col.type == BOOL_TYPE) key.i = value != 0 ? 1 : 0;
+  return activeOrNone(col.column->findKey(key));
+}
+
+int SnailDB::findRow(SnailColumnHandle &col, int64_t value) const {
+  if (!refresh(col) || col.type != INT64_TYPE) return -1;
+  SnailKey key = { true, 0, value, 0.0 };
+  return activeOrNone(col.column->findKey(key));
+}
+
+int SnailDB::findRow(SnailColumnHandle &col, double value) const {
+  if (!refresh(col) || (col.type != FLOAT_TYPE && col.type != DOUBLE_TYPE)) return -1;
+  SnailKey key = { true, 0, 0, value };
+  return activeOrNone(col.column->findKey(key));
+}
+
+int SnailDB::findRow(SnailColumnHandle &col, const std::string &value) const {
+  if (!refresh(col)) return -1;
+  return activeOrNone(col.column->find(value));
+}
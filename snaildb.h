@@ -2,27 +2,231 @@
 #ifndef SNAILDB_H
 #define SNAILDB_H
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 // Type Definitions (Migrated from snail_datatypes)
-enum ColumnType { STR_TYPE, INT_TYPE };
+// New types are appended: the numeric value is stored in .snail files.
+enum ColumnType { STR_TYPE, INT_TYPE, FLOAT_TYPE, DOUBLE_TYPE, INT64_TYPE, BOOL_TYPE };
+
+// Flag bits stored above the type in the .snail schema type byte
+static const uint8_t COL_TYPE_MASK = 0x7F;
+static const uint8_t COL_FLAG_ORDERED_DICT = 0x80; // STR: dictionary kept in string order
 
 struct ColumnInfo {
   std::string name;
   size_t max_length;
   ColumnType type;
+  bool orderedDict; // STR only (v1.1)
 };
 
 // Indexing Structures
 struct IndexEntry {
   uint32_t hash;
-  uint16_t rowIdx;
+  uint32_t rowIdx; // 32-bit: tables may exceed 65535 rows
+
+  // For sorting the index: rows of one hash stay in row order
+  bool operator<(const IndexEntry &other) const {
+    return hash != other.hash ? hash < other.hash : rowIdx < other.rowIdx;
+  }
+};
+
+// =========================================================
+// Memory Accounting & Instrumentation (v1.1)
+// =========================================================
+
+// Heap bytes in use (size) vs. held (capacity) for one kind of data
+struct SnailBytes {
+  size_t used;
+  size_t reserved;
+};
+
+struct SnailMemoryStats {
+  SnailBytes storage;    // Fixed-width values (INT/INT64/FLOAT/DOUBLE/BOOL)
+  SnailBytes tokens;     // STR token stream
+  SnailBytes dictionary; // STR dictionary strings
+  SnailBytes index;      // Hash indexes
+  SnailBytes tombstones; // activeRows (table level only)
+  SnailBytes timestamps; // timestamps (table level only)
+
+  size_t totalUsed() const {
+    return storage.used + tokens.used + dictionary.used + index.used +
+           tombstones.used + timestamps.used;
+  }
+  size_t totalReserved() const {
+    return storage.reserved + tokens.reserved + dictionary.reserved +
+           index.reserved + tombstones.reserved + timestamps.reserved;
+  }
+};
+
+// Hot-path counters and timing histograms. Compiled in only with
+// -DSNAILDB_STATS=1; otherwise the macros below expand to nothing. The
+// counters are process-wide and not synchronized (single-threaded use).
+// Per-row and per-lookup paths only count; timings cover bulk work (batch
+// inserts, imports, purge, save, load).
+#ifndef SNAILDB_STATS
+#define SNAILDB_STATS 0
+#endif
+
+struct SnailHistogram {
+  static const int BUCKETS = 16; // Bucket b: [2^b - 1, 2^(b+1) - 1) microseconds
+
+  uint32_t count;
+  uint64_t totalUs;
+  uint32_t maxUs;
+  uint32_t buckets[BUCKETS];
+
+  void record(uint32_t us);
+};
 
-  // For sorting the index
-  bool operator<(const IndexEntry &other) const { return hash < other.hash; }
+struct SnailStats {
+  uint32_t rowsInserted;
+  uint32_t batchInserts;
+  uint32_t findBinary;   // Sorted column: binary search
+  uint32_t findIndex;    // Hash index probe
+  uint32_t findScan;     // Linear scan fallback
+  uint32_t findDictMiss; // STR value not in dictionary: no scan needed
+  uint32_t indexMerges;  // Delta runs folded into a column index
+  uint32_t purges;
+  uint32_t saves;
+  uint32_t loads;
+
+  SnailHistogram insertTime; // insertBatch() and imports
+  SnailHistogram purgeTime;
+  SnailHistogram saveTime;
+  SnailHistogram loadTime;
+
+  static SnailStats &instance();
+  static bool enabled(); // Whether the library was built with SNAILDB_STATS
+  void reset();
+};
+
+uint32_t snailMicros();
+
+class SnailScopedTimer {
+public:
+  explicit SnailScopedTimer(SnailHistogram &h) : hist(h), start(snailMicros()) {}
+  ~SnailScopedTimer() { hist.record(snailMicros() - start); }
+
+private:
+  SnailHistogram &hist;
+  uint32_t start;
+};
+
+// The macros are for the library's .cpp files. Code inlined from headers
+// must not depend on SNAILDB_STATS (its body would differ between
+// translation units), so it uses this out-of-line scope instead. It does
+// nothing unless snaildb.cpp was built with stats.
+enum SnailStatOp { STAT_SAVE, STAT_LOAD };
+
+class SnailStatScope {
+public:
+  explicit SnailStatScope(SnailStatOp op);
+  ~SnailStatScope();
+
+private:
+  SnailStatOp op;
+  uint32_t start;
+};
+
+#if SNAILDB_STATS
+#define SNAIL_COUNT(counter, n) (SnailStats::instance().counter += (n))
+#define SNAIL_TIMED(hist) SnailScopedTimer snailTimer_##hist(SnailStats::instance().hist)
+#else
+#define SNAIL_COUNT(counter, n) ((void)0)
+#define SNAIL_TIMED(hist) ((void)0)
+#endif
+
+// Incremental Row Index (v1.1)
+// Sorted (hash, row) entries plus a small unsorted delta of appended rows.
+// Inserts only touch the delta; once it outgrows ~sqrt(main) it is sorted
+// and merged in, so a lookup never scans more than a short tail. Compaction
+// remaps row ids in place instead of dropping the index.
+class SnailRowIndex {
+public:
+  SnailRowIndex() : enabled(false) {}
+
+  bool isEnabled() const { return enabled; }
+  size_t size() const { return main.size() + delta.size(); }
+
+  // Takes the entries of every row (in row order) and enables the index
+  void build(std::vector<IndexEntry> &entries);
+  void clear();
+
+  void append(uint32_t hash, uint32_t rowIdx) {
+    if (!enabled) return;
+    IndexEntry e = { hash, rowIdx };
+    delta.push_back(e);
+    if (delta.size() >= deltaLimit()) merge();
+  }
+  void merge();
+  void compact(const std::vector<bool> &keepMask);
+
+  // Every row with this hash for which match(row) holds, in row order
+  template <typename Match>
+  void findAll(uint32_t hash, Match match, std::vector<uint32_t> &rows) const {
+    IndexEntry probe = { hash, 0 };
+    auto it = std::lower_bound(main.begin(), main.end(), probe);
+    for (; it != main.end() && it->hash == hash; ++it) {
+      if (match(it->rowIdx)) rows.push_back(it->rowIdx);
+    }
+    for (const IndexEntry &e : delta) {
+      if (e.hash == hash && match(e.rowIdx)) rows.push_back(e.rowIdx);
+    }
+  }
+
+  // Lowest row with this hash for which match(row) holds, or -1
+  template <typename Match> int find(uint32_t hash, Match match) const {
+    IndexEntry probe = { hash, 0 };
+    auto it = std::lower_bound(main.begin(), main.end(), probe);
+    for (; it != main.end() && it->hash == hash; ++it) {
+      if (match(it->rowIdx)) return (int)it->rowIdx;
+    }
+    // Delta rows were appended after every main row, in row order
+    for (const IndexEntry &e : delta) {
+      if (e.hash == hash && match(e.rowIdx)) return (int)e.rowIdx;
+    }
+    return -1;
+  }
+
+  void addMemoryStats(SnailBytes &bytes) const;
+
+private:
+  size_t deltaLimit() const;
+
+  std::vector<IndexEntry> main;  // Sorted by (hash, rowIdx)
+  std::vector<IndexEntry> delta; // Append order
+  bool enabled;
+};
+
+// Prepared Search Key (v1.1)
+// A search value converted once to a column's native form: the parsed int,
+// or the dictionary token for strings.
+struct SnailKey {
+  bool valid; // false: the value cannot match (e.g. string not in dictionary)
+  int32_t i;  // INT_TYPE value, STR_TYPE token or BOOL_TYPE 0/1
+  int64_t l;  // INT64_TYPE value
+  double d;   // FLOAT_TYPE / DOUBLE_TYPE value
+};
+
+// Dictionary Predicates (v1.1)
+// A string predicate evaluated once against a column's dictionary. With an
+// ordered dictionary the matching tokens form a single range [lo, hi);
+// otherwise a per-token mask is used. Rows are then filtered by token only,
+// with no string comparison per row.
+struct SnailTokenSet {
+  bool isRange;
+  uint16_t lo, hi;           // isRange: tokens in [lo, hi)
+  std::vector<uint8_t> mask; // !isRange: mask[token] != 0
+
+  bool contains(uint16_t token) const {
+    if (isRange) return token >= lo && token < hi;
+    return token < mask.size() && mask[token];
+  }
 };
 
 // Abstract Base Column Definition
@@ -54,8 +258,38 @@ public:
   virtual int getInt(size_t index) const { return 0; }
   virtual std::string getStr(size_t index) const { return ""; }
 
+  // Native Numeric Accessors (v1.1)
+  virtual void addInt64(int64_t val) {}
+  virtual void addFloat(float val) {}
+  virtual void addDouble(double val) {}
+  virtual void addBool(bool val) {}
+  virtual int64_t getInt64(size_t index) const { return 0; }
+  virtual float getFloat(size_t index) const { return 0.0f; }
+  virtual double getDouble(size_t index) const { return 0.0; }
+  virtual bool getBool(size_t index) const { return false; }
+
+  // Bulk Append (v1.1) - one call per column per batch
+  virtual void addInts(const int *vals, size_t n) {}
+  virtual void addStrs(const char *const *vals, size_t n) {}
+  virtual void addStrs(const std::string *vals, size_t n) {}
+  virtual void addInt64s(const int64_t *vals, size_t n) {}
+  virtual void addFloats(const float *vals, size_t n) {}
+  virtual void addDoubles(const double *vals, size_t n) {}
+  virtual void addBools(const bool *vals, size_t n) {}
+
   // Search
   virtual int find(const std::string &pattern) const = 0;
+
+  // Prepared Search (v1.1)
+  // resolveKey does the parsing / dictionary lookup once; findKey is only
+  // the search itself. A resolved key stays valid while getEpoch() is
+  // unchanged.
+  virtual SnailKey resolveKey(const std::string &pattern) const = 0;
+  virtual int findKey(const SnailKey &key) const = 0;
+  virtual uint32_t getEpoch() const { return 0; }
+
+  // Memory Accounting (v1.1): adds this column's bytes to 'stats'
+  virtual void addMemoryStats(SnailMemoryStats &stats) const = 0;
 };
 
 // =========================================================
@@ -64,6 +298,11 @@ public:
 
 class InternalIntColumn : public Column {
   friend class SnailStorage;
+  friend class SnailExecutor;
+  friend class SnailQuery;
+  friend class SnailExporter;
+  friend class SnailOrder;
+  friend class SnailJoin;
 
 public:
   InternalIntColumn();
@@ -74,21 +313,33 @@ public:
   bool isIndexed() const override;
   void compact(const std::vector<bool> &keepMask) override;
   void addInt(int val) override;
+  void addInts(const int *vals, size_t n) override;
   int getInt(size_t index) const override;
   void createIndex() override;
   int find(const std::string &pattern) const override;
+  SnailKey resolveKey(const std::string &pattern) const override;
+  int findKey(const SnailKey &key) const override;
+  void addMemoryStats(SnailMemoryStats &stats) const override;
+
+  // All rows equal to key via the index; false if there is no index
+  bool indexLookup(const SnailKey &key, std::vector<uint32_t> &rows) const;
 
 private:
   std::vector<int> storage;
-  std::vector<IndexEntry> index;
+  SnailRowIndex index;
   bool sorted = true;
 };
 
 class InternalStrColumn : public Column {
   friend class SnailStorage;
+  friend class SnailExecutor;
+  friend class SnailQuery;
+  friend class SnailExporter;
+  friend class SnailOrder;
+  friend class SnailJoin;
 
 public:
-  InternalStrColumn(size_t maxLen);
+  InternalStrColumn(size_t maxLen, bool orderedDict = false);
   ColumnType getType() const override;
   size_t size() const override;
   void reserve(size_t n) override;
@@ -96,30 +347,263 @@ public:
   bool isIndexed() const override;
   void compact(const std::vector<bool> &keepMask) override;
   void addStr(const std::string &val) override;
+  void addStrs(const char *const *vals, size_t n) override;
+  void addStrs(const std::string *vals, size_t n) override;
   std::string getStr(size_t index) const override;
   void createIndex() override;
   int find(const std::string &pattern) const override;
+  SnailKey resolveKey(const std::string &pattern) const override;
+  int findKey(const SnailKey &key) const override;
+  void addMemoryStats(SnailMemoryStats &stats) const override;
+  uint32_t getEpoch() const override;
+
+  // Order-Preserving Dictionary (v1.1)
+  // sortDictionary() reorders the dictionary lexically and remaps every
+  // token, so token order == string order. Appending a string that sorts
+  // after all existing ones keeps the order; any other new string breaks it
+  // until the next sortDictionary(). In ordered mode createIndex() re-sorts.
+  void setOrderedDictionary(bool on) { orderedDict = on; }
+  bool isOrderedDictionary() const { return orderedDict; }
+  bool isDictionarySorted() const { return dictSorted; }
+  void sortDictionary();
+
+  // Range / prefix predicates compiled against the dictionary. Null bounds
+  // are open-ended.
+  SnailTokenSet matchRange(const std::string *lo, bool loInclusive,
+                           const std::string *hi, bool hiInclusive) const;
+  SnailTokenSet matchPrefix(const std::string &prefix) const;
+  void selectRows(const SnailTokenSet &set, const std::vector<bool> &active,
+                  std::vector<uint32_t> &out) const;
+
+  // Lexical rank of every token (identity when the dictionary is sorted)
+  std::vector<uint16_t> dictionaryRanks() const;
+
+  // All rows equal to key via the index; false if there is no index
+  bool indexLookup(const SnailKey &key, std::vector<uint32_t> &rows) const;
+
+  // Columnar append of pre-tokenized rows (v1.1): tokens index 'localDict'.
+  // Each local entry is looked up once and the tokens are remapped.
+  void addTokens(const std::vector<std::string> &localDict, const uint16_t *tokens, size_t n);
 
 private:
+  template <typename S> void addStrsImpl(const S *vals, size_t n);
+  std::vector<IndexEntry> dictionaryLookup() const;
+  uint16_t intern(std::vector<IndexEntry> &lookup, const char *s, size_t len);
+  void noteNewEntry(); // Tracks dictSorted after an append
+  void buildIndex();
+
   size_t maxLength;
   // v0.9 Dictionary Compression
   std::vector<std::string> dictionary; // Unique strings
   std::vector<uint16_t> data;          // Token indices
-  std::vector<IndexEntry> index;
+  SnailRowIndex index;                 // (token, row), built by createIndex
+  bool sorted = true;      // Tokens non-decreasing (binary search by token)
+  bool orderedDict;        // Keep the dictionary sorted (re-sort on createIndex)
+  bool dictSorted = true;  // Dictionary currently in lexical order
+  uint32_t epoch = 0;      // Bumped whenever the dictionary changes
+};
+
+// Native fixed-width numeric column (v1.1): INT64, FLOAT and DOUBLE.
+// Values are stored at their real width; the numeric accessors convert, so
+// e.g. addInt64 on a DOUBLE column stores the value as a double.
+template <typename T, ColumnType TYPE> class InternalNumColumn : public Column {
+  friend class SnailStorage;
+  friend class SnailExecutor;
+  friend class SnailQuery;
+  friend class SnailExporter;
+  friend class SnailOrder;
+  friend class SnailJoin;
+
+public:
+  InternalNumColumn();
+  ColumnType getType() const override;
+  size_t size() const override;
+  void reserve(size_t n) override;
+  bool isSorted() const override;
+  bool isIndexed() const override;
+  void compact(const std::vector<bool> &keepMask) override;
+  void addInt64(int64_t val) override;
+  void addFloat(float val) override;
+  void addDouble(double val) override;
+  int getInt(size_t index) const override; // Converted, like getInt64()
+  int64_t getInt64(size_t index) const override;
+  float getFloat(size_t index) const override;
+  double getDouble(size_t index) const override;
+  void addInt64s(const int64_t *vals, size_t n) override;
+  void addFloats(const float *vals, size_t n) override;
+  void addDoubles(const double *vals, size_t n) override;
+  void createIndex() override;
+  int find(const std::string &pattern) const override;
+  SnailKey resolveKey(const std::string &pattern) const override;
+  int findKey(const SnailKey &key) const override;
+  void addMemoryStats(SnailMemoryStats &stats) const override;
+
+private:
+  void append(T val);
+  template <typename S> void appendAll(const S *vals, size_t n);
+
+  std::vector<T> storage;
   bool sorted = true;
 };
 
+typedef InternalNumColumn<int64_t, INT64_TYPE> InternalInt64Column;
+typedef InternalNumColumn<float, FLOAT_TYPE> InternalFloatColumn;
+typedef InternalNumColumn<double, DOUBLE_TYPE> InternalDoubleColumn;
+
+// Instantiated once in snaildb.cpp
+extern template class InternalNumColumn<int64_t, INT64_TYPE>;
+extern template class InternalNumColumn<float, FLOAT_TYPE>;
+extern template class InternalNumColumn<double, DOUBLE_TYPE>;
+
+// Bit-packed boolean column (v1.1): 8 rows per byte
+class InternalBoolColumn : public Column {
+  friend class SnailStorage;
+  friend class SnailExecutor;
+  friend class SnailQuery;
+  friend class SnailExporter;
+
+public:
+  InternalBoolColumn();
+  ColumnType getType() const override;
+  size_t size() const override;
+  void reserve(size_t n) override;
+  bool isSorted() const override;
+  bool isIndexed() const override;
+  void compact(const std::vector<bool> &keepMask) override;
+  void addBool(bool val) override;
+  void addBools(const bool *vals, size_t n) override;
+  bool getBool(size_t index) const override;
+  int getInt(size_t index) const override;
+  void createIndex() override;
+  int find(const std::string &pattern) const override;
+  SnailKey resolveKey(const std::string &pattern) const override;
+  int findKey(const SnailKey &key) const override;
+  void addMemoryStats(SnailMemoryStats &stats) const override;
+
+private:
+  std::vector<uint8_t> bits; // LSB-first within each byte
+  size_t count = 0;
+};
+
+// Bulk Insert (v1.1)
+// Describes N rows as one array per column. Only pointers are kept, so the
+// arrays must stay alive until SnailDB::insertBatch() returns.
+class SnailBatch {
+  friend class SnailDB;
+
+public:
+  explicit SnailBatch(size_t rows) : rows(rows), ts(nullptr), fixedTs(0) {}
+
+  void setInts(size_t colIdx, const int *vals) { set(colIdx, INT_TYPE, vals, false); }
+  void setStrs(size_t colIdx, const char *const *vals) { set(colIdx, STR_TYPE, vals, false); }
+  void setStrs(size_t colIdx, const std::string *vals) { set(colIdx, STR_TYPE, vals, true); }
+  void setInt64s(size_t colIdx, const int64_t *vals) { set(colIdx, INT64_TYPE, vals, false); }
+  void setFloats(size_t colIdx, const float *vals) { set(colIdx, FLOAT_TYPE, vals, false); }
+  void setDoubles(size_t colIdx, const double *vals) { set(colIdx, DOUBLE_TYPE, vals, false); }
+  void setBools(size_t colIdx, const bool *vals) { set(colIdx, BOOL_TYPE, vals, false); }
+
+  // Per-row timestamps, or one timestamp for the whole batch (default 0)
+  void setTimestamps(const uint32_t *vals) { ts = vals; }
+  void setTimestamp(uint32_t val) { ts = nullptr; fixedTs = val; }
+
+  size_t size() const { return rows; }
+
+private:
+  struct Slice {
+    ColumnType type;
+    const void *data;
+    bool stdString; // STR_TYPE only: std::string* instead of const char**
+  };
+
+  void set(size_t colIdx, ColumnType type, const void *data, bool stdString);
+
+  size_t rows;
+  std::vector<Slice> slices;
+  const uint32_t *ts;
+  uint32_t fixedTs;
+};
+
+class SnailDB;
+
+// Prepared Lookups (v1.1)
+// A column resolved once by name. SnailDB re-resolves it transparently if the
+// schema changes (addXColProp, SnailStorage::load) or if the handle is used
+// on a different table.
+class SnailColumnHandle {
+  friend class SnailDB;
+  friend class SnailExecutor;
+
+public:
+  SnailColumnHandle()
+      : colIdx(-1), column(nullptr), type(INT_TYPE), owner(nullptr), schemaEpoch(0) {}
+  explicit SnailColumnHandle(const std::string &colName)
+      : colName(colName), colIdx(-1), column(nullptr), type(INT_TYPE), owner(nullptr),
+        schemaEpoch(0) {}
+
+  const std::string &getColName() const { return colName; }
+  int getColIndex() const { return colIdx; }
+  ColumnType getType() const { return type; }
+
+private:
+  std::string colName;
+  int colIdx;
+  const Column *column;
+  ColumnType type;
+  const SnailDB *owner; // Table the handle was resolved on
+  uint32_t schemaEpoch; // Only meaningful for 'owner'
+};
+
+// An equality predicate whose value is already parsed (int) or mapped to a
+// dictionary token (string). Re-resolved only after a schema change or a
+// change to that column's dictionary.
+class SnailPredicate {
+  friend class SnailDB;
+  friend class SnailExecutor;
+
+public:
+  SnailPredicate() : key(), keyOwner(nullptr), keySchemaEpoch(0), keyEpoch(0), resolved(false) {}
+  SnailPredicate(const std::string &colName, const std::string &value)
+      : col(colName), value(value), key(), keyOwner(nullptr), keySchemaEpoch(0), keyEpoch(0),
+        resolved(false) {}
+
+  const SnailColumnHandle &getColumn() const { return col; }
+  const std::string &getValue() const { return value; }
+  void setValue(const std::string &v) { value = v; resolved = false; }
+
+private:
+  SnailColumnHandle col;
+  std::string value;
+  SnailKey key;
+  const SnailDB *keyOwner;
+  uint32_t keySchemaEpoch;
+  uint32_t keyEpoch;
+  bool resolved;
+};
+
 // SnailDB Main Class
 class SnailDB {
   friend class SnailStorage; // Allow access to private members for
                              // serialization
+  friend class SnailExecutor; // Parallel scans over the same vectors
+  friend class SnailQuery;    // Query pipelines read the columns directly
+  friend class SnailExporter;
+  friend class SnailOrder;
+  friend class SnailJoin;
+  friend class SnailImporter;
 public:
   SnailDB();
   virtual ~SnailDB();
 
   // Setup Schema
-  void addStrColProp(const std::string &colName, size_t max_length);
+  void addStrColProp(const std::string &colName, size_t max_length,
+                     bool orderedDict = false);
   void addIntColProp(const std::string &colName, size_t max_length);
+  void addInt64ColProp(const std::string &colName, size_t max_length);
+  void addFloatColProp(const std::string &colName, size_t max_length);
+  void addDoubleColProp(const std::string &colName, size_t max_length);
+  void addBoolColProp(const std::string &colName, size_t max_length);
+  void addColProp(const std::string &colName, size_t max_length, ColumnType type,
+                  bool orderedDict = false); // orderedDict: STR only
 
   // Memory & Optimization
   void reserve(size_t rows);
@@ -134,12 +618,14 @@ public:
     if (sizeof...(args) != colNames.size())
       return;
     insertImpl(0, args...);
-    // System fields
-    activeRows.push_back(true);
-    timestamps.push_back(ts);
-    numRows++;
+    appendRow(ts);
   }
 
+  // Bulk Insert (v1.1)
+  // Appends every row of the batch in one pass per column. Returns false
+  // (and inserts nothing) if a column is missing or has the wrong type.
+  bool insertBatch(const SnailBatch &batch);
+
   // Typed Data Access
   template <typename T> T get(size_t colIndex) const;
 
@@ -161,10 +647,34 @@ public:
   size_t getColCount() const { return colNames.size(); }
   std::string getColName(size_t idx) const { return colNames[idx]; }
   ColumnType getColType(size_t idx) const;
+  bool hasOrderedDictionary(size_t idx) const; // STR column created with orderedDict
+
+  // String Range Queries (v1.1) - STR columns only, rows in row order.
+  // Evaluated once on the dictionary, then on tokens with integer compares.
+  bool sortDictionary(const std::string &colName);
+  std::vector<uint32_t> findLessThan(const std::string &colName, const std::string &value) const;
+  std::vector<uint32_t> findBetween(const std::string &colName, const std::string &lo,
+                                    const std::string &hi) const; // Inclusive
+  std::vector<uint32_t> findPrefix(const std::string &colName, const std::string &prefix) const;
+
+  // Memory Accounting (v1.1)
+  SnailMemoryStats getMemoryStats() const; // Whole table
+  SnailMemoryStats getColMemoryStats(size_t idx) const;
 
   // Helpers
   int findRow(const std::string &colName, const std::string &value) const;
 
+  // Prepared Lookups (v1.1)
+  // Handles cache the column resolution, predicates also cache the parsed
+  // value / token. Both are refreshed in place when they go stale.
+  SnailColumnHandle prepareColumn(const std::string &colName) const;
+  SnailPredicate prepare(const std::string &colName, const std::string &value) const;
+  int findRow(SnailPredicate &pred) const;
+  int findRow(SnailColumnHandle &col, int value) const;     // INT_TYPE
+  int findRow(SnailColumnHandle &col, int64_t value) const; // INT64_TYPE
+  int findRow(SnailColumnHandle &col, double value) const;  // FLOAT/DOUBLE
+  int findRow(SnailColumnHandle &col, const std::string &value) const;
+
 protected:
   std::vector<std::unique_ptr<Column>> columns;
   std::vector<std::string> colNames;
@@ -173,13 +683,22 @@ protected:
   // System Vectors (v1.0)
   std::vector<bool> activeRows;
   std::vector<uint32_t> timestamps;
+  bool tsSorted; // Timestamps non-decreasing (time ranges by binary search)
 
   size_t numRows;
   size_t cursor;
+  uint32_t schemaEpoch; // Bumped on every schema change
 
   int getColIndex(const std::string &name) const;
+  bool refresh(SnailColumnHandle &col) const;
+  bool resolve(SnailPredicate &pred) const;
+  const InternalStrColumn *strColumn(const std::string &colName) const;
+  int activeOrNone(int rowIdx) const;
+  void compactSystem(); // Timestamps + tombstones, after columns compacted
 
 private:
+  void appendRow(uint32_t ts); // System fields of one inserted row
+
   // Recursive variadic unpacker
   void insertImpl(size_t colIdx) {} // Base case
 
@@ -190,9 +709,21 @@ private:
   }
 
   // Typed dispatch helpers
-  void addToCol(size_t colIdx, int val);
+  // Any arithmetic argument is converted to the target column's native type
+  template <typename N>
+  typename std::enable_if<std::is_integral<N>::value>::type
+  addToCol(size_t colIdx, N val) {
+    addIntegral(colIdx, (int64_t)val);
+  }
+  template <typename N>
+  typename std::enable_if<std::is_floating_point<N>::value>::type
+  addToCol(size_t colIdx, N val) {
+    addFloating(colIdx, (double)val);
+  }
   void addToCol(size_t colIdx, const std::string &val);
   void addToCol(size_t colIdx, const char *val);
+  void addIntegral(size_t colIdx, int64_t val);
+  void addFloating(size_t colIdx, double val);
 };
 
 // Template Specializations / Definitions
@@ -209,4 +740,28 @@ inline std::string SnailDB::get<std::string>(size_t colIndex) const {
   return columns[colIndex]->getStr(cursor);
 }
 
+template <> inline int64_t SnailDB::get<int64_t>(size_t colIndex) const {
+  if (colIndex >= columns.size())
+    return 0;
+  return columns[colIndex]->getInt64(cursor);
+}
+
+template <> inline float SnailDB::get<float>(size_t colIndex) const {
+  if (colIndex >= columns.size())
+    return 0.0f;
+  return columns[colIndex]->getFloat(cursor);
+}
+
+template <> inline double SnailDB::get<double>(size_t colIndex) const {
+  if (colIndex >= columns.size())
+    return 0.0;
+  return columns[colIndex]->getDouble(cursor);
+}
+
+template <> inline bool SnailDB::get<bool>(size_t colIndex) const {
+  if (colIndex >= columns.size())
+    return false;
+  return columns[colIndex]->getBool(cursor);
+}
+
 #endif // SNAILDB_H
\ No newline at end of file